@@ -0,0 +1,69 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+// Multi-producer multi-consumer queue. Push blocks while queue is full, so a slow
+// consumer slows producers down instead of growing memory
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity)
+        : capacity_(capacity) {
+    }
+
+    // false if queue is closed, item is dropped then
+    bool Push(T item) {
+        std::unique_lock lock(mutex_);
+        not_full_.wait(lock, [this] { return closed_ || items_.size() < capacity_; });
+        if (closed_) {
+            return false;
+        }
+        items_.push_back(std::move(item));
+        not_empty_.notify_one();
+        return true;
+    }
+
+    // false if queue is full or closed
+    bool TryPush(T& item) {
+        std::lock_guard lock(mutex_);
+        if (closed_ || items_.size() >= capacity_) {
+            return false;
+        }
+        items_.push_back(std::move(item));
+        not_empty_.notify_one();
+        return true;
+    }
+
+    // nullopt once queue is closed and drained
+    std::optional<T> Pop() {
+        std::unique_lock lock(mutex_);
+        not_empty_.wait(lock, [this] { return closed_ || !items_.empty(); });
+        if (items_.empty()) {
+            return std::nullopt;
+        }
+        T item = std::move(items_.front());
+        items_.pop_front();
+        not_full_.notify_one();
+        return item;
+    }
+
+    // wakes every waiter, queued items can still be popped
+    void Close() {
+        std::lock_guard lock(mutex_);
+        closed_ = true;
+        not_full_.notify_all();
+        not_empty_.notify_all();
+    }
+
+private:
+    const size_t capacity_;
+    std::mutex mutex_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+    std::deque<T> items_;
+    bool closed_ = false;
+};
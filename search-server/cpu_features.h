@@ -0,0 +1,38 @@
+#pragma once
+
+// CPU feature detection and target attributes of the SIMD kernels, internal to the .cpp files using them
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+#define SEARCH_SERVER_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define TARGET_SSE2
+#define TARGET_AVX2
+#else
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+#ifdef SEARCH_SERVER_X86
+
+inline bool CpuHasAvx2() {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+inline bool CpuHasSse2() {
+#if defined(__x86_64__) || defined(_M_X64)
+    return true;                // part of x86-64 baseline
+#else
+    return __builtin_cpu_supports("sse2");
+#endif
+}
+
+#endif
@@ -0,0 +1,114 @@
+#include "executor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+
+namespace {
+
+    // HINT : shared with helper tasks, which may start after ParallelFor has returned
+    struct ParallelForState {
+        ParallelForState(size_t count_in, size_t batch_in, const std::function<void(size_t)>& body_in)
+            : count(count_in)
+            , batch(batch_in)
+            , body(&body_in) {
+        }
+
+        const size_t count;
+        const size_t batch;
+        const std::function<void(size_t)>* body;      // valid while done < count
+        std::atomic<size_t> next = 0;
+        std::atomic<bool> failed = false;
+
+        std::mutex mutex;
+        std::condition_variable all_done;
+        size_t done = 0;
+        std::exception_ptr error;
+
+        // takes batches until none is left
+        void Work() {
+            while (true) {
+                const size_t begin = next.fetch_add(batch);
+                if (begin >= count) {
+                    return;
+                }
+                const size_t end = std::min(begin + batch, count);
+                std::exception_ptr batch_error;
+                for (size_t i = begin; i < end && !failed; ++i) {
+                    try {
+                        (*body)(i);
+                    }
+                    catch (...) {
+                        batch_error = std::current_exception();
+                        failed = true;
+                    }
+                }
+                std::lock_guard lock(mutex);
+                if (batch_error && !error) {
+                    error = batch_error;
+                }
+                done += end - begin;
+                if (done == count) {
+                    all_done.notify_all();
+                }
+            }
+        }
+    };
+
+}
+
+/************************************ SEQUENTIAL ************************************/
+
+void SequentialExecutor::ParallelFor(size_t count, const std::function<void(size_t)>& body) {
+    for (size_t i = 0; i < count; ++i) {
+        body(i);
+    }
+}
+
+size_t SequentialExecutor::GetConcurrency() const {
+    return 1;
+}
+
+/************************************ THREAD POOL ************************************/
+
+ThreadPoolExecutor::ThreadPoolExecutor(const ExecutorOptions& options)
+    : pool_(options.thread_count, std::max<size_t>(options.queue_capacity, 1), options.cpus) {
+}
+
+void ThreadPoolExecutor::ParallelFor(size_t count, const std::function<void(size_t)>& body) {
+    if (count == 0) {
+        return;
+    }
+    // a few batches per thread keep per-index overhead low and still even out uneven indices
+    const size_t workers = pool_.GetThreadCount() + 1;
+    const size_t batch = std::max<size_t>(1, count / (workers * 4));
+    auto state = std::make_shared<ParallelForState>(count, batch, body);
+
+    // helpers are offered, not awaited: a full queue leaves the work to the caller
+    const size_t helpers = std::min(pool_.GetThreadCount(), (count + batch - 1) / batch - 1);
+    for (size_t i = 0; i < helpers; ++i) {
+        ThreadPool::Task task = [state] { state->Work(); };
+        if (!pool_.TrySubmit(task)) {
+            break;
+        }
+    }
+    state->Work();
+
+    std::unique_lock lock(state->mutex);
+    state->all_done.wait(lock, [&] { return state->done == count; });
+    if (state->error) {
+        std::rethrow_exception(state->error);
+    }
+}
+
+size_t ThreadPoolExecutor::GetConcurrency() const {
+    return pool_.GetThreadCount() + 1;
+}
+
+Executor& DefaultExecutor() {
+    static ThreadPoolExecutor executor(ExecutorOptions{ std::max<size_t>(std::thread::hardware_concurrency(), 2) - 1, {}, 1024 });
+    return executor;
+}
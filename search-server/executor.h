@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "thread_pool.h"
+
+struct ExecutorOptions {
+    size_t thread_count = std::thread::hardware_concurrency();
+    std::vector<int> cpus;              // worker i is pinned to cpus[i % cpus.size()], empty -> not pinned. Linux only
+    size_t queue_capacity = 1024;       // helper tasks waiting for a worker
+};
+
+// Runs the parallel parts of SearchServer and ProcessQueries. One executor may be shared
+// by several servers, or every server may get its own to keep their threads apart
+class Executor {
+public:
+    virtual ~Executor() = default;
+
+    // body(i) for every i in [0, count) on any threads including the caller, returns once all
+    // are done. The first exception of body is rethrown, indices not started by then are skipped.
+    // Nested calls from inside body are allowed
+    virtual void ParallelFor(size_t count, const std::function<void(size_t)>& body) = 0;
+
+    // threads body may run on at once
+    virtual size_t GetConcurrency() const = 0;
+};
+
+// everything on the calling thread
+class SequentialExecutor : public Executor {
+public:
+    void ParallelFor(size_t count, const std::function<void(size_t)>& body) override;
+    size_t GetConcurrency() const override;
+};
+
+// Fixed pool of options.thread_count workers. The caller works on its own ParallelFor too and
+// never waits for a helper that has not started, so a busy or nested pool can't deadlock
+class ThreadPoolExecutor : public Executor {
+public:
+    // throws std::invalid_argument on zero threads, std::runtime_error if pinning fails
+    explicit ThreadPoolExecutor(const ExecutorOptions& options = {});
+
+    void ParallelFor(size_t count, const std::function<void(size_t)>& body) override;
+    size_t GetConcurrency() const override;
+
+private:
+    ThreadPool pool_;
+};
+
+// process-wide pool of hardware_concurrency threads counting the caller, created on first use
+Executor& DefaultExecutor();
@@ -0,0 +1,92 @@
+#include "index_snapshot.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+uint64_t SnapshotChecksum(const char* data, size_t size) {
+    // FNV-1a over 8-byte words, tail bytes are mixed one by one
+    const uint64_t prime = 1099511628211ull;
+    uint64_t hash = 14695981039346656037ull;
+    size_t pos = 0;
+    for (; pos + sizeof(uint64_t) <= size; pos += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, data + pos, sizeof(word));
+        hash = (hash ^ word) * prime;
+    }
+    for (; pos < size; ++pos) {
+        hash = (hash ^ static_cast<unsigned char>(data[pos])) * prime;
+    }
+    return hash;
+}
+
+/************************************ WRITER ************************************/
+
+void SnapshotWriter::WriteRaw(SnapshotSectionId id, const char* data, size_t bytes, size_t count) {
+    payload_.resize((payload_.size() + 7) & ~size_t{ 7 }, '\0');
+    header_.sections[id].offset = payload_.size();
+    header_.sections[id].count = count;
+    payload_.append(data, bytes);
+}
+
+void SnapshotWriter::Save(const std::string& path) {
+    std::memcpy(header_.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header_.payload_size = payload_.size();
+    header_.checksum = SnapshotChecksum(payload_.data(), payload_.size());
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header_), sizeof(header_));
+    out.write(payload_.data(), static_cast<std::streamsize>(payload_.size()));
+    out.flush();
+    if (!out) {
+        throw std::runtime_error("Can't write snapshot " + path);
+    }
+}
+
+/************************************ READER ************************************/
+
+SnapshotView::SnapshotView(const char* image, size_t size, bool verify_checksum) {
+    if (size < sizeof(SnapshotHeader)) {
+        throw std::runtime_error("Snapshot is truncated");
+    }
+    header_ = reinterpret_cast<const SnapshotHeader*>(image);
+    payload_ = image + sizeof(SnapshotHeader);
+
+    if (std::memcmp(header_->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+        throw std::runtime_error("Not a snapshot file");
+    }
+    if (header_->version != SNAPSHOT_VERSION || header_->header_size != sizeof(SnapshotHeader)) {
+        throw std::runtime_error("Unsupported snapshot version");
+    }
+    if (header_->payload_size != size - sizeof(SnapshotHeader)) {
+        throw std::runtime_error("Snapshot is truncated");
+    }
+    if (verify_checksum && SnapshotChecksum(payload_, header_->payload_size) != header_->checksum) {
+        throw std::runtime_error("Snapshot checksum mismatch");
+    }
+
+    const size_t element_sizes[SNAPSHOT_SECTION_COUNT] = {
+        1, sizeof(SnapshotString), sizeof(SnapshotTerm), sizeof(SnapshotPosting), sizeof(SnapshotDocument), sizeof(SnapshotForward)
+    };
+    for (int id = 0; id < SNAPSHOT_SECTION_COUNT; ++id) {
+        const SnapshotSection& section = header_->sections[id];
+        if (section.offset % 8 != 0 || section.offset > header_->payload_size
+            || section.count > (header_->payload_size - section.offset) / element_sizes[id]) {
+            throw std::runtime_error("Snapshot section is out of bounds");
+        }
+    }
+}
+
+std::vector<char> ReadSnapshotFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        throw std::runtime_error("Can't open snapshot " + path);
+    }
+    std::vector<char> image(static_cast<size_t>(in.tellg()));
+    in.seekg(0);
+    in.read(image.data(), static_cast<std::streamsize>(image.size()));
+    if (!in) {
+        throw std::runtime_error("Can't read snapshot " + path);
+    }
+    return image;
+}
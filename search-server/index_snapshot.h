@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// On-disk layout of SearchServer::SaveSnapshot().
+// Header is followed by the payload, every section is a plain array aligned to 8 bytes,
+// so the file can be read in one piece and used in place.
+
+const char SNAPSHOT_MAGIC[8] = { 'S', 'R', 'C', 'H', 'I', 'D', 'X', '\0' };
+const uint32_t SNAPSHOT_VERSION = 1;
+
+enum SnapshotSectionId {
+    SNAPSHOT_STRINGS,           // char blob for every text below
+    SNAPSHOT_STOP_WORDS,        // SnapshotString, sorted
+    SNAPSHOT_TERMS,             // SnapshotTerm, sorted by text
+    SNAPSHOT_POSTINGS,          // SnapshotPosting, grouped by term, sorted by id
+    SNAPSHOT_DOCUMENTS,         // SnapshotDocument, sorted by id
+    SNAPSHOT_FORWARD,           // SnapshotForward, grouped by document, sorted by term
+    SNAPSHOT_SECTION_COUNT,
+};
+
+struct SnapshotSection {
+    uint64_t offset = 0;        // from the start of payload
+    uint64_t count = 0;         // elements, bytes for SNAPSHOT_STRINGS
+};
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version = SNAPSHOT_VERSION;
+    uint32_t header_size = sizeof(SnapshotHeader);
+    uint64_t payload_size = 0;
+    uint64_t checksum = 0;      // SnapshotChecksum() of payload
+    SnapshotSection sections[SNAPSHOT_SECTION_COUNT];
+};
+
+struct SnapshotString {
+    uint64_t offset = 0;
+    uint64_t length = 0;
+};
+
+struct SnapshotTerm {
+    SnapshotString text;
+    uint64_t posting_begin = 0;
+    uint64_t posting_count = 0;
+};
+
+struct SnapshotPosting {
+    int32_t document_id = 0;
+    uint32_t reserved = 0;
+    double term_freq = 0.0;
+};
+
+struct SnapshotDocument {
+    int32_t id = 0;
+    int32_t rating = 0;
+    int32_t status = 0;
+    uint32_t reserved = 0;
+    SnapshotString content;
+    uint64_t forward_begin = 0;
+    uint64_t forward_count = 0;
+};
+
+struct SnapshotForward {
+    uint32_t term_index = 0;
+    uint32_t reserved = 0;
+    double term_freq = 0.0;
+};
+
+static_assert(sizeof(SnapshotHeader) == 32 + 16 * SNAPSHOT_SECTION_COUNT, "Snapshot header must be packed");
+static_assert(sizeof(SnapshotTerm) == 32, "Snapshot term must be packed");
+static_assert(sizeof(SnapshotPosting) == 16, "Snapshot posting must be packed");
+static_assert(sizeof(SnapshotDocument) == 48, "Snapshot document must be packed");
+static_assert(sizeof(SnapshotForward) == 16, "Snapshot forward entry must be packed");
+
+uint64_t SnapshotChecksum(const char* data, size_t size);
+
+// Builds the payload section by section and keeps every section 8-byte aligned
+class SnapshotWriter {
+public:
+    template <typename T>
+    void WriteSection(SnapshotSectionId id, const std::vector<T>& items) {
+        WriteRaw(id, reinterpret_cast<const char*>(items.data()), items.size() * sizeof(T), items.size());
+    }
+
+    void WriteSection(SnapshotSectionId id, const std::string& blob) {
+        WriteRaw(id, blob.data(), blob.size(), blob.size());
+    }
+
+    // throws std::runtime_error if file can't be written
+    void Save(const std::string& path);
+
+private:
+    void WriteRaw(SnapshotSectionId id, const char* data, size_t bytes, size_t count);
+
+    SnapshotHeader header_{};
+    std::string payload_;
+};
+
+// Validated view over a snapshot image. Pointers stay valid while the image is alive
+class SnapshotView {
+public:
+    SnapshotView() = default;
+
+    // throws std::runtime_error on wrong magic, version, size or checksum
+    SnapshotView(const char* image, size_t size, bool verify_checksum = true);
+
+    template <typename T>
+    const T* Section(SnapshotSectionId id) const {
+        return reinterpret_cast<const T*>(payload_ + header_->sections[id].offset);
+    }
+
+    size_t Count(SnapshotSectionId id) const {
+        return static_cast<size_t>(header_->sections[id].count);
+    }
+
+    // throws std::runtime_error if str runs out of the strings section
+    std::string_view Text(const SnapshotString& str) const {
+        const uint64_t strings_size = header_->sections[SNAPSHOT_STRINGS].count;
+        if (str.offset > strings_size || str.length > strings_size - str.offset) {
+            throw std::runtime_error("Snapshot string is out of bounds");
+        }
+        return { payload_ + header_->sections[SNAPSHOT_STRINGS].offset + str.offset, static_cast<size_t>(str.length) };
+    }
+
+private:
+    const SnapshotHeader* header_ = nullptr;
+    const char* payload_ = nullptr;
+};
+
+// reads whole file with one bulk read, throws std::runtime_error if file can't be read
+std::vector<char> ReadSnapshotFile(const std::string& path);
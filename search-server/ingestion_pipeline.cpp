@@ -0,0 +1,191 @@
+#include "ingestion_pipeline.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "bounded_queue.h"
+#include "read_input_functions.h"
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    // HINT : whole records only, ids start from first_document_id
+    struct Chunk {
+        std::unique_ptr<std::string> text;
+        int first_document_id = 0;
+    };
+
+    // HINT : words point into text, so text travels with them
+    struct TokenizedChunk {
+        std::unique_ptr<std::string> text;
+        std::vector<SearchServer::TokenizedDocument> documents;
+    };
+
+    double SecondsSince(Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    std::string_view NextLine(std::string_view& text) {
+        const size_t end = text.find('\n');
+        std::string_view line = text.substr(0, end);
+        text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        return line;
+    }
+
+    void ReadChunks(std::FILE* input, const IngestionOptions& options, BoundedQueue<Chunk>& chunks, IngestionStats& stats) {
+        std::string carry;
+        int next_document_id = options.first_document_id;
+        bool eof = false;
+        while (!eof) {
+            const Clock::time_point start = Clock::now();
+            auto text = std::make_unique<std::string>(std::move(carry));
+            const size_t carried = text->size();
+            text->resize(carried + options.chunk_bytes);
+            const size_t got = std::fread(text->data() + carried, 1, options.chunk_bytes, input);
+            text->resize(carried + got);
+            eof = got < options.chunk_bytes;
+            stats.bytes_read += got;
+
+            // cut after the last complete record, the rest goes to the next chunk
+            size_t lines = 0;
+            size_t cut = 0;
+            for (const char* pos = text->data(); (pos = static_cast<const char*>(std::memchr(pos, '\n', text->data() + text->size() - pos))) != nullptr; ++pos) {
+                if (++lines % 2 == 0) {
+                    cut = pos - text->data() + 1;
+                }
+            }
+            if (eof) {
+                lines += text->size() > 0 && text->back() != '\n' ? 1 : 0;
+                cut = text->size();
+            }
+            else {
+                lines -= lines % 2;
+            }
+            carry.assign(*text, cut, std::string::npos);
+            text->resize(cut);
+
+            const int records = static_cast<int>((lines + 1) / 2);
+            stats.reader_busy_seconds += SecondsSince(start);
+            if (records == 0) {
+                continue;
+            }
+            ++stats.chunks_read;
+            if (!chunks.Push({ std::move(text), next_document_id })) {
+                break;
+            }
+            next_document_id += records;
+        }
+        chunks.Close();
+    }
+
+}
+
+IngestionStats IngestCorpus(SearchServer& search_server, std::FILE* input, IngestionOptions options) {
+    options.tokenizer_threads = std::max<size_t>(options.tokenizer_threads, 1);
+    options.chunk_bytes = std::max<size_t>(options.chunk_bytes, 1);
+
+    IngestionStats stats;
+    BoundedQueue<Chunk> chunks(options.queue_capacity);
+    BoundedQueue<TokenizedChunk> tokenized(options.queue_capacity);
+
+    std::atomic<uint64_t> documents_tokenized = 0;
+    std::atomic<uint64_t> documents_rejected = 0;
+    std::atomic<int64_t> tokenizer_busy_ns = 0;
+    std::atomic<size_t> active_tokenizers = options.tokenizer_threads;
+
+    std::thread reader(ReadChunks, input, std::cref(options), std::ref(chunks), std::ref(stats));
+
+    // tokenizing needs only const access to the server, so it runs beside indexing
+    std::vector<std::thread> tokenizers;
+    for (size_t i = 0; i < options.tokenizer_threads; ++i) {
+        tokenizers.emplace_back([&] {
+            while (std::optional<Chunk> chunk = chunks.Pop()) {
+                const Clock::time_point start = Clock::now();
+                TokenizedChunk out{ std::move(chunk->text), {} };
+                std::string_view rest(*out.text);
+                for (int document_id = chunk->first_document_id; !rest.empty(); ++document_id) {
+                    const std::string_view content = NextLine(rest);
+                    const std::string_view ratings = NextLine(rest);
+                    try {
+                        out.documents.push_back(search_server.TokenizeDocument({ document_id, content, options.status, ParseRatings(ratings) }));
+                    }
+                    catch (const std::invalid_argument&) {
+                        ++documents_rejected;
+                    }
+                }
+                documents_tokenized += out.documents.size();
+                tokenizer_busy_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+                if (!tokenized.Push(std::move(out))) {
+                    break;
+                }
+            }
+            if (--active_tokenizers == 0) {
+                tokenized.Close();
+            }
+        });
+    }
+
+    auto stop_pipeline = [&] {
+        chunks.Close();
+        tokenized.Close();
+        reader.join();
+        for (std::thread& tokenizer : tokenizers) {
+            tokenizer.join();
+        }
+    };
+
+    try {
+        while (std::optional<TokenizedChunk> chunk = tokenized.Pop()) {
+            const Clock::time_point start = Clock::now();
+            for (const SearchServer::TokenizedDocument& document : chunk->documents) {
+                try {
+                    if (search_server.AddTokenizedDocument(document)) {
+                        ++stats.documents_indexed;
+                    }
+                    else {
+                        ++documents_rejected;
+                    }
+                }
+                catch (const std::invalid_argument&) {
+                    ++documents_rejected;
+                }
+            }
+            stats.indexer_busy_seconds += SecondsSince(start);
+        }
+    }
+    catch (...) {
+        stop_pipeline();
+        throw;
+    }
+    stop_pipeline();
+
+    stats.documents_tokenized = documents_tokenized;
+    stats.documents_rejected = documents_rejected;
+    stats.tokenizer_busy_seconds = tokenizer_busy_ns * 1e-9;
+    return stats;
+}
+
+IngestionStats IngestCorpus(SearchServer& search_server, const std::string& path, IngestionOptions options) {
+    std::FILE* input = std::fopen(path.c_str(), "rb");
+    if (input == nullptr) {
+        throw std::runtime_error("Can't open corpus " + path);
+    }
+    try {
+        IngestionStats stats = IngestCorpus(search_server, input, options);
+        std::fclose(input);
+        return stats;
+    }
+    catch (...) {
+        std::fclose(input);
+        throw;
+    }
+}
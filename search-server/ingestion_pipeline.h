@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+#include "search_server.h"
+
+// Corpus dump format is the one ReadLine()/ReadLineWithNumber() read:
+//   document text
+//   ratings count r1 r2 ... rN
+// repeated for every document, ids are given in file order.
+
+struct IngestionOptions {
+    size_t chunk_bytes = 4 << 20;                           // one read() per chunk
+    size_t queue_capacity = 8;                              // chunks in flight between two stages
+    size_t tokenizer_threads = std::thread::hardware_concurrency();
+    int first_document_id = 0;
+    DocumentStatus status = DocumentStatus::ACTUAL;
+};
+
+// HINT : per stage throughput counters, busy time excludes waiting on queues
+struct IngestionStats {
+    uint64_t bytes_read = 0;
+    uint64_t chunks_read = 0;
+    uint64_t documents_tokenized = 0;
+    uint64_t documents_indexed = 0;
+    uint64_t documents_rejected = 0;            // special symbols, bad ratings, duplicate ids or rejected duplicates
+    double reader_busy_seconds = 0.0;
+    double tokenizer_busy_seconds = 0.0;        // summed over workers
+    double indexer_busy_seconds = 0.0;
+};
+
+// reader -> bounded queue -> tokenizer pool -> bounded queue -> indexer (calling thread)
+IngestionStats IngestCorpus(SearchServer& search_server, std::FILE* input, IngestionOptions options = {});
+// throws std::runtime_error if file can't be opened
+IngestionStats IngestCorpus(SearchServer& search_server, const std::string& path, IngestionOptions options = {});
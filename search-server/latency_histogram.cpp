@@ -0,0 +1,166 @@
+#include "latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+
+    // HINT : threads get shards round robin on their first record, so up to shard_count threads never share one
+    std::atomic<size_t> next_thread_index{ 0 };
+
+    // index of the highest set bit, value > 0
+    size_t HighestBit(uint64_t value) {
+#ifdef _MSC_VER
+        unsigned long index = 0;
+        _BitScanReverse64(&index, value);
+        return index;
+#else
+        return 63 - __builtin_clzll(value);
+#endif
+    }
+
+}
+
+std::ostream& operator<<(std::ostream& os, const LatencySummary& summary) {
+    return os << "count " << summary.count
+        << ", p50 " << summary.p50.count()
+        << " ns, p90 " << summary.p90.count()
+        << " ns, p99 " << summary.p99.count()
+        << " ns, p999 " << summary.p999.count()
+        << " ns, max " << summary.max.count() << " ns";
+}
+
+LatencyHistogram::LatencyHistogram(size_t shard_count)
+    : shards_(shard_count) {
+    if (shard_count == 0) {
+        throw std::invalid_argument("Shard count must be positive");
+    }
+}
+
+LatencyHistogram::~LatencyHistogram() {
+    for (std::atomic<Shard*>& shard : shards_) {
+        delete shard.load();
+    }
+}
+
+size_t LatencyHistogram::BucketOf(uint64_t nanoseconds) {
+    nanoseconds = std::min(nanoseconds, (uint64_t{ 1 } << VALUE_BITS) - 1);
+    if (nanoseconds < SUB_BUCKET_COUNT) {
+        return static_cast<size_t>(nanoseconds);
+    }
+    // HINT : power of two [2^bit, 2^(bit + 1)) owns buckets of width 2^(bit - SUB_BUCKET_BITS)
+    const size_t bit = HighestBit(nanoseconds);
+    const size_t shift = bit - SUB_BUCKET_BITS;
+    return (shift + 1) * SUB_BUCKET_COUNT + static_cast<size_t>((nanoseconds >> shift) - SUB_BUCKET_COUNT);
+}
+
+uint64_t LatencyHistogram::BucketUpperBound(size_t bucket) {
+    if (bucket < SUB_BUCKET_COUNT) {
+        return bucket;
+    }
+    const size_t shift = bucket / SUB_BUCKET_COUNT - 1;
+    const uint64_t lower = static_cast<uint64_t>(SUB_BUCKET_COUNT + bucket % SUB_BUCKET_COUNT) << shift;
+    return lower + (uint64_t{ 1 } << shift) - 1;
+}
+
+LatencyHistogram::Shard& LatencyHistogram::ShardOfThisThread() {
+    thread_local const size_t thread_index = next_thread_index.fetch_add(1, std::memory_order_relaxed);
+    std::atomic<Shard*>& slot = shards_[thread_index % shards_.size()];
+    Shard* shard = slot.load(std::memory_order_acquire);
+    if (shard == nullptr) {
+        // two threads of one shard may race here, the loser frees its copy
+        Shard* fresh = new Shard();
+        if (slot.compare_exchange_strong(shard, fresh, std::memory_order_acq_rel)) {
+            shard = fresh;
+        }
+        else {
+            delete fresh;
+        }
+    }
+    return *shard;
+}
+
+void LatencyHistogram::Record(std::chrono::nanoseconds latency) {
+    const uint64_t nanoseconds = static_cast<uint64_t>(std::max<int64_t>(latency.count(), 0));
+    ShardOfThisThread().counts[BucketOf(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+}
+
+std::vector<uint64_t> LatencyHistogram::MergeCounts() const {
+    std::vector<uint64_t> counts(BUCKET_COUNT);
+    for (const std::atomic<Shard*>& slot : shards_) {
+        const Shard* shard = slot.load(std::memory_order_acquire);
+        if (shard == nullptr) {
+            continue;
+        }
+        for (size_t bucket = 0; bucket < BUCKET_COUNT; ++bucket) {
+            counts[bucket] += shard->counts[bucket].load(std::memory_order_relaxed);
+        }
+    }
+    return counts;
+}
+
+std::chrono::nanoseconds LatencyHistogram::Percentile(const std::vector<uint64_t>& counts, uint64_t total, double quantile) {
+    if (total == 0) {
+        return std::chrono::nanoseconds(0);
+    }
+    // HINT : rank of the latency in increasing order, from 1
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(std::clamp(quantile, 0.0, 1.0) * total)));
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < counts.size(); ++bucket) {
+        seen += counts[bucket];
+        if (seen >= rank) {
+            return std::chrono::nanoseconds(BucketUpperBound(bucket));
+        }
+    }
+    return std::chrono::nanoseconds(BucketUpperBound(counts.size() - 1));
+}
+
+uint64_t LatencyHistogram::GetCount() const {
+    const std::vector<uint64_t> counts = MergeCounts();
+    uint64_t total = 0;
+    for (const uint64_t count : counts) {
+        total += count;
+    }
+    return total;
+}
+
+std::chrono::nanoseconds LatencyHistogram::GetPercentile(double quantile) const {
+    const std::vector<uint64_t> counts = MergeCounts();
+    uint64_t total = 0;
+    for (const uint64_t count : counts) {
+        total += count;
+    }
+    return Percentile(counts, total, quantile);
+}
+
+LatencySummary LatencyHistogram::GetSummary() const {
+    // one merge for every percentile, so they are consistent with each other
+    const std::vector<uint64_t> counts = MergeCounts();
+    LatencySummary summary;
+    for (const uint64_t count : counts) {
+        summary.count += count;
+    }
+    summary.p50 = Percentile(counts, summary.count, 0.5);
+    summary.p90 = Percentile(counts, summary.count, 0.9);
+    summary.p99 = Percentile(counts, summary.count, 0.99);
+    summary.p999 = Percentile(counts, summary.count, 0.999);
+    summary.max = Percentile(counts, summary.count, 1.0);
+    return summary;
+}
+
+void LatencyHistogram::Reset() {
+    for (std::atomic<Shard*>& slot : shards_) {
+        Shard* shard = slot.load(std::memory_order_acquire);
+        if (shard == nullptr) {
+            continue;
+        }
+        for (std::atomic<uint64_t>& count : shard->counts) {
+            count.store(0, std::memory_order_relaxed);
+        }
+    }
+}
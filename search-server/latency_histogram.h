@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+struct LatencySummary {
+    uint64_t count = 0;
+    std::chrono::nanoseconds p50{ 0 };
+    std::chrono::nanoseconds p90{ 0 };
+    std::chrono::nanoseconds p99{ 0 };
+    std::chrono::nanoseconds p999{ 0 };
+    std::chrono::nanoseconds max{ 0 };
+};
+
+// "count 12, p50 1200 ns, p90 ..., max ... ns"
+std::ostream& operator<<(std::ostream& os, const LatencySummary& summary);
+
+// Latencies in log-linear buckets as in HdrHistogram: values below 32 ns are exact, every
+// following power of two is split into 32 equal buckets, so a value is known within 1/32 of itself.
+// Values from 2^40 ns (~18 minutes) on share the last bucket. Counters are sharded by thread,
+// a shard is allocated by the first thread writing to it, reads merge all shards.
+// Record may run concurrently with everything, values recorded during a read may be seen or not
+class LatencyHistogram {
+public:
+    explicit LatencyHistogram(size_t shard_count = 16);
+    ~LatencyHistogram();
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    void Record(std::chrono::nanoseconds latency);
+
+    uint64_t GetCount() const;
+    // upper bound of the bucket holding the quantile-th latency, quantile in [0, 1], 0 if nothing is recorded
+    std::chrono::nanoseconds GetPercentile(double quantile) const;
+    LatencySummary GetSummary() const;
+    void Reset();
+
+private:
+    static const size_t SUB_BUCKET_BITS = 5;
+    static const size_t SUB_BUCKET_COUNT = size_t{ 1 } << SUB_BUCKET_BITS;
+    static const size_t VALUE_BITS = 40;
+    static const size_t BUCKET_COUNT = (VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+    struct Shard {
+        std::atomic<uint64_t> counts[BUCKET_COUNT] = {};
+    };
+
+    // HINT : nullptr -> no thread has written to the shard yet
+    std::vector<std::atomic<Shard*>> shards_;
+
+    static size_t BucketOf(uint64_t nanoseconds);
+    static uint64_t BucketUpperBound(size_t bucket);
+
+    Shard& ShardOfThisThread();
+    std::vector<uint64_t> MergeCounts() const;
+    static std::chrono::nanoseconds Percentile(const std::vector<uint64_t>& counts, uint64_t total, double quantile);
+};
+
+// records time from construction to destruction into histogram, exceptions included
+class LatencyTimer {
+public:
+    explicit LatencyTimer(LatencyHistogram& histogram)
+        : histogram_(histogram) {
+    }
+
+    ~LatencyTimer() {
+        histogram_.Record(std::chrono::steady_clock::now() - start_);
+    }
+
+    LatencyTimer(const LatencyTimer&) = delete;
+    LatencyTimer& operator=(const LatencyTimer&) = delete;
+
+private:
+    LatencyHistogram& histogram_;
+    const std::chrono::steady_clock::time_point start_ = std::chrono::steady_clock::now();
+};
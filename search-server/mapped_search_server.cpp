@@ -0,0 +1,183 @@
+#include "mapped_search_server.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "string_processing.h"
+
+/************************************ CONSTRUCTORS ************************************/
+
+MappedSearchServer::MappedSearchServer(const std::string& path, MappedIndexOptions options) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Can't open index " + path);
+    }
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0) {
+        close(fd);
+        throw std::runtime_error("Can't stat index " + path);
+    }
+    size_ = static_cast<size_t>(file_stat.st_size);
+
+    int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+    if (options.populate) {
+        flags |= MAP_POPULATE;
+    }
+#endif
+    image_ = mmap(nullptr, size_, PROT_READ, flags, fd, 0);
+    close(fd);                      // mapping keeps the file alive
+    if (image_ == MAP_FAILED) {
+        image_ = nullptr;
+        throw std::runtime_error("Can't map index " + path);
+    }
+
+    try {
+        view_ = SnapshotView(static_cast<const char*>(image_), size_, options.verify_checksum);
+        stop_words_ = view_.Section<SnapshotString>(SNAPSHOT_STOP_WORDS);
+        terms_ = view_.Section<SnapshotTerm>(SNAPSHOT_TERMS);
+        postings_ = view_.Section<SnapshotPosting>(SNAPSHOT_POSTINGS);
+        documents_ = view_.Section<SnapshotDocument>(SNAPSHOT_DOCUMENTS);
+        forward_ = view_.Section<SnapshotForward>(SNAPSHOT_FORWARD);
+        CheckRanges();
+    }
+    catch (...) {
+        munmap(image_, size_);
+        throw;
+    }
+    Advise(options.access);
+}
+
+MappedSearchServer::~MappedSearchServer() {
+    if (image_ != nullptr) {
+        munmap(image_, size_);
+    }
+}
+
+/************************************ PUBLIC METHODS ************************************/
+
+void MappedSearchServer::Advise(MappedAccess access) const {
+    int advice = MADV_NORMAL;
+    switch (access) {
+    case MappedAccess::NORMAL:
+        advice = MADV_NORMAL;
+        break;
+    case MappedAccess::RANDOM:
+        advice = MADV_RANDOM;
+        break;
+    case MappedAccess::SEQUENTIAL:
+        advice = MADV_SEQUENTIAL;
+        break;
+    case MappedAccess::WILL_NEED:
+        advice = MADV_WILLNEED;
+        break;
+    }
+    // only a hint, failure doesn't change results
+    madvise(image_, size_, advice);
+}
+
+std::vector<Document> MappedSearchServer::FindTopDocuments(const std::string_view raw_query, DocumentStatus stat) const {
+    return FindTopDocuments(raw_query, [stat](int, DocumentStatus status, int) { return status == stat; });
+}
+
+std::vector<Document> MappedSearchServer::FindTopDocuments(const std::string_view raw_query) const {
+    return FindTopDocuments(raw_query, DocumentStatus::ACTUAL);
+}
+
+std::tuple<std::vector<std::string_view>, DocumentStatus> MappedSearchServer::MatchDocument(const std::string_view raw_query, int document_id) const {
+    const SnapshotDocument* document = FindDocument(document_id);
+    if (document == nullptr) {
+        throw std::out_of_range("Invalid ID\n");
+    }
+    const Query query = ParseQuery(raw_query);
+    const SnapshotForward* first = forward_ + document->forward_begin;
+    const SnapshotForward* last = first + document->forward_count;
+
+    // forward entries are sorted by term index, terms are sorted by text
+    auto contains = [&](const std::string_view word) {
+        const SnapshotTerm* term = FindTerm(word);
+        if (term == nullptr) {
+            return false;
+        }
+        const uint32_t term_index = static_cast<uint32_t>(term - terms_);
+        const SnapshotForward* it = std::lower_bound(first, last, term_index,
+            [](const SnapshotForward& entry, uint32_t index) { return entry.term_index < index; });
+        return it != last && it->term_index == term_index;
+    };
+
+    std::vector<std::string_view> matched_words;
+    const DocumentStatus status = static_cast<DocumentStatus>(document->status);
+    for (const std::string_view word : query.minus_words) {
+        if (contains(word)) {
+            return std::make_tuple(matched_words, status);
+        }
+    }
+    for (const std::string_view word : query.plus_words) {
+        if (contains(word)) {
+            matched_words.push_back(view_.Text(FindTerm(word)->text));
+        }
+    }
+    return std::make_tuple(matched_words, status);
+}
+
+int MappedSearchServer::GetDocumentCount() const {
+    return static_cast<int>(view_.Count(SNAPSHOT_DOCUMENTS));
+}
+
+/************************************ PRIVATE METHODS ************************************/
+
+MappedSearchServer::Query MappedSearchServer::ParseQuery(const std::string_view text) const {
+    // same syntax as SearchServer, the snapshot holds the terms it normalized
+    return ParseQueryText(text, [this](const std::string_view word) { return IsStopWord(word); });
+}
+
+bool MappedSearchServer::IsStopWord(const std::string_view word) const {
+    const SnapshotString* last = stop_words_ + view_.Count(SNAPSHOT_STOP_WORDS);
+    const SnapshotString* it = std::lower_bound(stop_words_, last, word,
+        [this](const SnapshotString& str, const std::string_view value) { return view_.Text(str) < value; });
+    return it != last && view_.Text(*it) == word;
+}
+
+const SnapshotTerm* MappedSearchServer::FindTerm(const std::string_view word) const {
+    const SnapshotTerm* last = terms_ + view_.Count(SNAPSHOT_TERMS);
+    const SnapshotTerm* it = std::lower_bound(terms_, last, word,
+        [this](const SnapshotTerm& term, const std::string_view value) { return view_.Text(term.text) < value; });
+    return it != last && view_.Text(it->text) == word ? it : nullptr;
+}
+
+void MappedSearchServer::CheckRanges() const {
+    // Text() throws on a string out of the strings section
+    for (size_t i = 0; i < view_.Count(SNAPSHOT_STOP_WORDS); ++i) {
+        view_.Text(stop_words_[i]);
+    }
+    const uint64_t posting_count = view_.Count(SNAPSHOT_POSTINGS);
+    for (size_t i = 0; i < view_.Count(SNAPSHOT_TERMS); ++i) {
+        view_.Text(terms_[i].text);
+        if (terms_[i].posting_begin > posting_count || terms_[i].posting_count > posting_count - terms_[i].posting_begin) {
+            throw std::runtime_error("Snapshot posting is out of bounds");
+        }
+    }
+    // FindDocument() searches documents by id, so they must be sorted
+    const uint64_t forward_count = view_.Count(SNAPSHOT_FORWARD);
+    for (size_t i = 0; i < view_.Count(SNAPSHOT_DOCUMENTS); ++i) {
+        view_.Text(documents_[i].content);
+        if (documents_[i].forward_begin > forward_count || documents_[i].forward_count > forward_count - documents_[i].forward_begin) {
+            throw std::runtime_error("Snapshot forward index is out of bounds");
+        }
+        if (documents_[i].status < static_cast<int32_t>(DocumentStatus::ACTUAL) || documents_[i].status > static_cast<int32_t>(DocumentStatus::REMOVED)) {
+            throw std::runtime_error("Snapshot document status is out of range");
+        }
+        if (i > 0 && documents_[i - 1].id >= documents_[i].id) {
+            throw std::runtime_error("Snapshot documents are not sorted by id");
+        }
+    }
+}
+
+const SnapshotDocument* MappedSearchServer::FindDocument(int document_id) const {
+    const SnapshotDocument* last = documents_ + view_.Count(SNAPSHOT_DOCUMENTS);
+    const SnapshotDocument* it = std::lower_bound(documents_, last, document_id,
+        [](const SnapshotDocument& document, int id) { return document.id < id; });
+    return it != last && it->id == document_id ? it : nullptr;
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <tuple>
+#include <map>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+#include "document.h"
+#include "index_snapshot.h"
+#include "search_server.h"
+
+// HINT : madvise() hint for the mapped index
+enum class MappedAccess {
+    NORMAL,
+    RANDOM,             // point lookups, kernel readahead off
+    SEQUENTIAL,         // full scans
+    WILL_NEED,          // warm up page cache in background
+};
+
+struct MappedIndexOptions {
+    MappedAccess access = MappedAccess::RANDOM;
+    bool populate = false;              // MAP_POPULATE, prefault every page on open
+    bool verify_checksum = true;        // reads the whole file, turn off for fast startup of a trusted file
+};
+
+// Read-only search server working straight from a SearchServer::SaveSnapshot() file.
+// Nothing is deserialized, pages are shared with every process mapping the same file.
+// Every string, posting range and forward range is checked once on open, a broken file
+// throws std::runtime_error there instead of being read out of bounds later
+class MappedSearchServer {
+public:
+    explicit MappedSearchServer(const std::string& path, MappedIndexOptions options = {});
+    ~MappedSearchServer();
+
+    MappedSearchServer(const MappedSearchServer&) = delete;
+    MappedSearchServer& operator=(const MappedSearchServer&) = delete;
+
+    void Advise(MappedAccess access) const;
+
+    template <typename Predicate>
+    std::vector<Document> FindTopDocuments(const std::string_view raw_query, Predicate predicate) const;
+    std::vector<Document> FindTopDocuments(const std::string_view raw_query, DocumentStatus stat) const;
+    std::vector<Document> FindTopDocuments(const std::string_view raw_query) const;
+
+    // matched words point into the mapped file
+    std::tuple<std::vector<std::string_view>, DocumentStatus>
+        MatchDocument(const std::string_view raw_query, int document_id) const;
+
+    int GetDocumentCount() const;
+
+private:
+    using Query = ParsedQuery;
+
+    Query ParseQuery(const std::string_view text) const;
+
+    bool IsStopWord(const std::string_view word) const;
+
+    // nullptr if word isn't indexed
+    const SnapshotTerm* FindTerm(const std::string_view word) const;
+
+    // nullptr if document doesn't exist
+    const SnapshotDocument* FindDocument(int document_id) const;
+
+    // throws std::runtime_error if a range of a term or document runs out of its section
+    void CheckRanges() const;
+
+    template <typename Predicate>
+    std::vector<Document> FindAllDocuments(const Query& query, Predicate predicate) const;
+
+private:
+    void* image_ = nullptr;
+    size_t size_ = 0;
+    SnapshotView view_;
+
+    const SnapshotString* stop_words_ = nullptr;
+    const SnapshotTerm* terms_ = nullptr;
+    const SnapshotPosting* postings_ = nullptr;
+    const SnapshotDocument* documents_ = nullptr;
+    const SnapshotForward* forward_ = nullptr;
+};
+
+/************************************ TEMPLATE METHODS ************************************/
+
+template <typename Predicate>
+std::vector<Document> MappedSearchServer::FindTopDocuments(const std::string_view raw_query, Predicate predicate) const {
+    const Query query = ParseQuery(raw_query);
+
+    std::vector<Document> matched_documents = FindAllDocuments(query, predicate);
+    KeepTopDocuments(matched_documents);
+    return matched_documents;
+}
+
+template <typename Predicate>
+std::vector<Document> MappedSearchServer::FindAllDocuments(const Query& query, Predicate predicate) const {
+    std::map<int, double> document_to_relevance;
+    for (const std::string_view word : query.plus_words) {
+        const SnapshotTerm* term = FindTerm(word);
+        if (term == nullptr) {
+            continue;
+        }
+        const double inverse_document_freq = std::log(GetDocumentCount() * 1.0 / term->posting_count);
+        const SnapshotPosting* posting = postings_ + term->posting_begin;
+        for (uint64_t i = 0; i < term->posting_count; ++i) {
+            const SnapshotDocument* document = FindDocument(posting[i].document_id);
+            if (document == nullptr) {          // posting of a document the file doesn't have
+                continue;
+            }
+            if (predicate(document->id, static_cast<DocumentStatus>(document->status), document->rating)) {
+                document_to_relevance[document->id] += posting[i].term_freq * inverse_document_freq;
+            }
+        }
+    }
+
+    // docs with minus-words removing
+    for (const std::string_view word : query.minus_words) {
+        const SnapshotTerm* term = FindTerm(word);
+        if (term == nullptr) {
+            continue;
+        }
+        const SnapshotPosting* posting = postings_ + term->posting_begin;
+        for (uint64_t i = 0; i < term->posting_count; ++i) {
+            document_to_relevance.erase(posting[i].document_id);
+        }
+    }
+
+    // only documents found above got relevance
+    std::vector<Document> matched_documents;
+    for (const auto& [document_id, relevance] : document_to_relevance) {
+        const SnapshotDocument* document = FindDocument(document_id);
+        if (document != nullptr) {
+            matched_documents.push_back({ document_id, relevance, document->rating });
+        }
+    }
+    return matched_documents;
+}
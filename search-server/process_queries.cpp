@@ -1,29 +1,153 @@
-#include <execution>
-
-#include "process_queries.h"
-
-//  N      N, i-      FindTopDocuments  i- 
-std::vector<std::vector<Document>> ProcessQueries(const SearchServer& search_server, const std::vector<std::string>& queries) {
-	std::vector<std::vector<Document>> ret(queries.size());
-	
-	std::transform(std::execution::par, 
-		queries.begin(), queries.end(), 
-		ret.begin(), 
-		[&](const std::string& query) { return search_server.FindTopDocuments(query); });
-
-	return ret;
-}
-
-//       FindTopDocuments   ,      
-std::vector<Document> ProcessQueriesJoined(const SearchServer& search_server, const std::vector<std::string>& queries) {
-	std::vector<Document> ret;
-	std::vector<std::vector<Document>> tmp = ProcessQueries(search_server, queries);
-
-	for (const std::vector<Document>& i : tmp) {
-		for (const Document& j : i) {
-			ret.push_back(j);
-		}
-	}
-
-	return ret;
-}
+#include <atomic>
+#include <exception>
+#include <execution>
+#include <mutex>
+
+#include "process_queries.h"
+
+namespace {
+
+	// HINT : indices [begin, end) left to a worker, owner takes from the front, thieves take the back half
+	struct alignas(64) WorkerRange {
+		std::mutex mutex;
+		size_t begin = 0;
+		size_t end = 0;
+	};
+
+	bool PopOwn(WorkerRange& range, size_t& index) {
+		std::lock_guard lock(range.mutex);
+		if (range.begin == range.end) {
+			return false;
+		}
+		index = range.begin++;
+		return true;
+	}
+
+	//       :    ,   
+	bool Steal(std::vector<WorkerRange>& ranges, size_t self, size_t& index) {
+		for (size_t offset = 1; offset < ranges.size(); ++offset) {
+			WorkerRange& victim = ranges[(self + offset) % ranges.size()];
+			size_t begin = 0;
+			size_t end = 0;
+			{
+				std::lock_guard lock(victim.mutex);
+				if (victim.begin == victim.end) {
+					continue;
+				}
+				begin = victim.begin + (victim.end - victim.begin) / 2;
+				end = victim.end;
+				victim.end = begin;
+			}
+			std::lock_guard lock(ranges[self].mutex);
+			ranges[self].begin = begin + 1;
+			ranges[self].end = end;
+			index = begin;
+			return true;
+		}
+		return false;
+	}
+
+	// FindTopDocuments    MAX_RESULT_DOCUMENT_COUNT ,    
+	//      ,         .
+	// run(store)   store(i, )   
+	template <typename Run>
+	QueryBatchResults CollectBatch(size_t query_count, Run run) {
+		const size_t stride = MAX_RESULT_DOCUMENT_COUNT;
+		QueryBatchResults ret;
+		ret.documents.resize(query_count * stride);
+		ret.offsets.resize(query_count + 1);			// HINT : offsets[i + 1] holds count of i-th query before packing
+
+		run([&ret, stride](size_t index, const std::vector<Document>& documents) {
+			std::copy(documents.begin(), documents.end(), ret.documents.begin() + index * stride);
+			ret.offsets[index + 1] = documents.size();
+		});
+
+		size_t total = 0;
+		for (size_t index = 0; index < query_count; ++index) {
+			const size_t count = ret.offsets[index + 1];
+			std::copy_n(ret.documents.begin() + index * stride, count, ret.documents.begin() + total);
+			ret.offsets[index] = total;
+			total += count;
+		}
+		ret.offsets[query_count] = total;
+		ret.documents.resize(total);
+		return ret;
+	}
+
+}
+
+//  N      N, i-      FindTopDocuments  i- 
+std::vector<std::vector<Document>> ProcessQueries(const SearchServer& search_server, const std::vector<std::string>& queries) {
+	std::vector<std::vector<Document>> ret(queries.size());
+
+	//      ,   
+	ProcessQueriesStreaming(search_server, queries,
+		[&ret](size_t index, std::vector<Document> documents) { ret[index] = std::move(documents); });
+
+	return ret;
+}
+
+QueryBatchResults ProcessQueriesFlat(const SearchServer& search_server, const std::vector<std::string>& queries) {
+	return CollectBatch(queries.size(), [&](const auto& store) {
+		ProcessQueriesStreaming(search_server, queries,
+			[&store](size_t index, std::vector<Document> documents) { store(index, documents); });
+	});
+}
+
+//     ,          
+QueryBatchResults ProcessQueriesShared(const SearchServer& search_server, const std::vector<std::string>& queries) {
+	LatencyTimer timer(search_server.GetLatencyHistogram(ServerOperation::PROCESS_QUERIES));
+	return CollectBatch(queries.size(), [&](const auto& store) {
+		search_server.FindTopDocumentsShared(queries, DocumentStatus::ACTUAL, store);
+	});
+}
+
+//       FindTopDocuments   ,      
+std::vector<Document> ProcessQueriesJoined(const SearchServer& search_server, const std::vector<std::string>& queries) {
+	return ProcessQueriesFlat(search_server, queries).documents;
+}
+
+//      ,      :   
+//    ,  ,    .    executor .
+//      QueryArenaScope  ,     
+void ProcessQueriesStreaming(const SearchServer& search_server, const std::vector<std::string>& queries,
+	const QueryResultCallback& callback, size_t worker_count) {
+	//     , ProcessQueries, ProcessQueriesFlat  ProcessQueriesJoined    
+	LatencyTimer timer(search_server.GetLatencyHistogram(ServerOperation::PROCESS_QUERIES));
+	Executor& executor = search_server.GetExecutor();
+	if (worker_count == 0) {
+		worker_count = executor.GetConcurrency();
+	}
+	worker_count = std::max<size_t>(1, std::min(worker_count, queries.size()));
+	std::vector<WorkerRange> ranges(worker_count);
+	for (size_t i = 0; i < worker_count; ++i) {
+		ranges[i].begin = queries.size() * i / worker_count;
+		ranges[i].end = queries.size() * (i + 1) / worker_count;
+	}
+
+	std::atomic<bool> failed = false;
+	std::exception_ptr error;
+	std::mutex error_mutex;
+
+	auto work = [&](size_t self) {
+		size_t index = 0;
+		while (!failed && (PopOwn(ranges[self], index) || Steal(ranges, self, index))) {
+			try {
+				callback(index, search_server.FindTopDocuments(queries[index]));
+			}
+			catch (...) {
+				std::lock_guard lock(error_mutex);
+				if (!error) {
+					error = std::current_exception();
+				}
+				failed = true;
+			}
+		}
+	};
+
+	executor.ParallelFor(worker_count, work);
+
+	if (error) {
+		std::rethrow_exception(error);
+	}
+}
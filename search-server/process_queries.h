@@ -1,13 +1,51 @@
-#pragma once
-
-#include <vector>
-
-#include "search_server.h"
-
-std::vector<std::vector<Document>> ProcessQueries(
-    const SearchServer& search_server,
-    const std::vector<std::string>& queries);
-
-std::vector<Document> ProcessQueriesJoined(
-    const SearchServer& search_server,
-    const std::vector<std::string>& queries);
\ No newline at end of file
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "search_server.h"
+
+std::vector<std::vector<Document>> ProcessQueries(
+    const SearchServer& search_server,
+    const std::vector<std::string>& queries);
+
+// HINT : results of many queries back to back, i-th query owns documents[offsets[i], offsets[i + 1])
+struct QueryBatchResults {
+    std::vector<Document> documents;
+    std::vector<size_t> offsets;
+
+    size_t Size() const {
+        return offsets.empty() ? 0 : offsets.size() - 1;
+    }
+
+    IteratorRange<std::vector<Document>::const_iterator> Documents(size_t index) const {
+        return { documents.begin() + offsets[index], documents.begin() + offsets[index + 1] };
+    }
+};
+
+// results of all queries in one buffer, filled in parallel
+QueryBatchResults ProcessQueriesFlat(
+    const SearchServer& search_server,
+    const std::vector<std::string>& queries);
+
+// ProcessQueriesFlat for big offline batches, see SearchServer::FindTopDocumentsShared
+QueryBatchResults ProcessQueriesShared(
+    const SearchServer& search_server,
+    const std::vector<std::string>& queries);
+
+// documents of ProcessQueriesFlat, handed over without copying
+std::vector<Document> ProcessQueriesJoined(
+    const SearchServer& search_server,
+    const std::vector<std::string>& queries);
+
+// (query_index, documents) of a finished query, may be called from several threads at once
+using QueryResultCallback = std::function<void(size_t, std::vector<Document>)>;
+
+// Runs FindTopDocuments for every query on worker_count work-stealing workers and hands every
+// result to callback as soon as it is ready, in no particular order. Workers run on the server's
+// executor, 0 -> one per executor thread. Throws the first exception of a query
+void ProcessQueriesStreaming(
+    const SearchServer& search_server,
+    const std::vector<std::string>& queries,
+    const QueryResultCallback& callback,
+    size_t worker_count = 0);
\ No newline at end of file
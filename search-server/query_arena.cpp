@@ -0,0 +1,131 @@
+#include "query_arena.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <optional>
+
+namespace {
+
+    const size_t INITIAL_ARENA_BYTES = 16 << 10;
+    const size_t MAX_ARENA_BYTES = 16 << 20;        // bigger queries use the heap for the excess
+
+    class CountingResource : public std::pmr::memory_resource {
+    public:
+        void Reset(std::pmr::memory_resource* upstream) {
+            upstream_ = upstream;
+            allocations = 0;
+            bytes = 0;
+        }
+
+        uint64_t allocations = 0;
+        uint64_t bytes = 0;
+
+    private:
+        void* do_allocate(size_t bytes_count, size_t alignment) override {
+            ++allocations;
+            bytes += bytes_count;
+            return upstream_->allocate(bytes_count, alignment);
+        }
+
+        void do_deallocate(void* pointer, size_t bytes_count, size_t alignment) override {
+            upstream_->deallocate(pointer, bytes_count, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+
+        std::pmr::memory_resource* upstream_ = nullptr;
+    };
+
+    std::atomic<uint64_t> total_queries = 0;
+    std::atomic<uint64_t> total_allocations = 0;
+    std::atomic<uint64_t> total_bytes = 0;
+    std::atomic<uint64_t> total_upstream_allocations = 0;
+
+    // HINT : counting -> monotonic over buffer -> upstream counting -> heap
+    class ThreadArena {
+    public:
+        ThreadArena() {
+            Rebuild(INITIAL_ARENA_BYTES);
+        }
+
+        std::pmr::memory_resource* Resource() {
+            return &counting_;
+        }
+
+        void Release() {
+            const uint64_t spilled = upstream_.bytes;
+            total_queries += 1;
+            total_allocations += counting_.allocations;
+            total_bytes += counting_.bytes;
+            total_upstream_allocations += upstream_.allocations;
+
+            if (spilled > 0 && buffer_size_ < MAX_ARENA_BYTES) {
+                // next query of this size fits into the buffer
+                Rebuild(std::min(MAX_ARENA_BYTES, std::max(2 * buffer_size_, buffer_size_ + static_cast<size_t>(spilled))));
+            }
+            else {
+                monotonic_->release();
+                counting_.Reset(&*monotonic_);
+                upstream_.Reset(std::pmr::new_delete_resource());
+            }
+        }
+
+        int depth = 0;
+
+    private:
+        void Rebuild(size_t size) {
+            monotonic_.reset();
+            buffer_ = std::make_unique<std::byte[]>(size);
+            buffer_size_ = size;
+            upstream_.Reset(std::pmr::new_delete_resource());
+            monotonic_.emplace(buffer_.get(), buffer_size_, &upstream_);
+            counting_.Reset(&*monotonic_);
+        }
+
+        std::unique_ptr<std::byte[]> buffer_;
+        size_t buffer_size_ = 0;
+        CountingResource upstream_;
+        std::optional<std::pmr::monotonic_buffer_resource> monotonic_;
+        CountingResource counting_;
+    };
+
+    ThreadArena& LocalArena() {
+        thread_local ThreadArena arena;
+        return arena;
+    }
+
+}
+
+QueryArenaScope::QueryArenaScope() {
+    ++LocalArena().depth;
+}
+
+QueryArenaScope::~QueryArenaScope() {
+    ThreadArena& arena = LocalArena();
+    if (--arena.depth == 0) {
+        arena.Release();
+    }
+}
+
+std::pmr::memory_resource* QueryArenaScope::Resource() const {
+    return LocalArena().Resource();
+}
+
+QueryArenaStats GetQueryArenaStats() {
+    QueryArenaStats stats;
+    stats.queries = total_queries;
+    stats.allocations = total_allocations;
+    stats.bytes = total_bytes;
+    stats.upstream_allocations = total_upstream_allocations;
+    return stats;
+}
+
+void ResetQueryArenaStats() {
+    total_queries = 0;
+    total_allocations = 0;
+    total_bytes = 0;
+    total_upstream_allocations = 0;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <memory_resource>
+
+struct QueryArenaStats {
+    uint64_t queries = 0;
+    uint64_t allocations = 0;           // served by arenas
+    uint64_t bytes = 0;
+    uint64_t upstream_allocations = 0;  // arena ran out of its buffer and went to the heap
+
+    double AllocationsPerQuery() const {
+        return queries == 0 ? 0.0 : static_cast<double>(allocations) / queries;
+    }
+};
+
+// Scratch memory of the calling thread for one query. Every thread has its own
+// monotonic arena, so workers don't meet in malloc. Scopes nest, the arena is
+// released when the outermost scope closes, and its buffer grows to fit the
+// biggest query seen, so steady state queries don't touch the heap.
+// Nothing allocated from Resource() may outlive the scope
+class QueryArenaScope {
+public:
+    QueryArenaScope();
+    ~QueryArenaScope();
+
+    QueryArenaScope(const QueryArenaScope&) = delete;
+    QueryArenaScope& operator=(const QueryArenaScope&) = delete;
+
+    std::pmr::memory_resource* Resource() const;
+};
+
+// summed over all threads, a thread reports when its outermost scope closes
+QueryArenaStats GetQueryArenaStats();
+void ResetQueryArenaStats();
@@ -1,16 +1,51 @@
-#include "read_input_functions.h"
-
-#include <iostream>
-
-std::string ReadLine() {
-    std::string s;
-    std::getline(std::cin, s);
-    return s;
-}
-
-int ReadLineWithNumber() {
-    int result = 0;
-    std::cin >> result;
-    ReadLine();
-    return result;
-}
\ No newline at end of file
+#include "read_input_functions.h"
+
+#include <charconv>
+#include <iostream>
+#include <stdexcept>
+
+std::string ReadLine() {
+    std::string s;
+    std::getline(std::cin, s);
+    return s;
+}
+
+int ReadLineWithNumber() {
+    int result = 0;
+    std::cin >> result;
+    ReadLine();
+    return result;
+}
+
+std::vector<int> ParseRatings(std::string_view line) {
+    std::vector<int> ratings;
+    const char* pos = line.data();
+    const char* end = line.data() + line.size();
+
+    auto next_number = [&](int& value) {
+        while (pos < end && *pos == ' ') {
+            ++pos;
+        }
+        const auto [ptr, ec] = std::from_chars(pos, end, value);
+        if (ec != std::errc()) {
+            return false;
+        }
+        pos = ptr;
+        return true;
+    };
+
+    int count = 0;
+    if (!next_number(count) || count < 0) {
+        return ratings;
+    }
+    // HINT : every rating takes a space and a digit at least
+    const size_t room = static_cast<size_t>(end - pos + 1) / 2;
+    if (static_cast<size_t>(count) > room) {
+        throw std::invalid_argument("Rating count exceeds the line");
+    }
+    ratings.reserve(count);
+    for (int rating = 0; ratings.size() < static_cast<size_t>(count) && next_number(rating);) {
+        ratings.push_back(rating);
+    }
+    return ratings;
+}
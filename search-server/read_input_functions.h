@@ -1,6 +1,12 @@
-#pragma once
-
-#include <string>
-
-std::string ReadLine();
-int ReadLineWithNumber();
\ No newline at end of file
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+std::string ReadLine();
+int ReadLineWithNumber();
+
+// HINT : "count r1 r2 ... rN" -> { r1, r2, ... rN }, parsed with from_chars.
+// Throws invalid_argument if count is more than the rest of the line could hold
+std::vector<int> ParseRatings(std::string_view line);
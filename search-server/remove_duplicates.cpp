@@ -1,29 +1,16 @@
-#include "remove_duplicates.h"
-
-#include <vector>
-#include <iostream>
-
-void RemoveDuplicates(SearchServer& search_server) {
-    std::set<std::set<std::string>> word_sets;
-    std::vector<int> ids_to_remove;
-
-    std::set<std::string> doc_words;
-
-    for (const int doc_id : search_server) {
-        for (const std::pair<std::string, double>& i : search_server.GetWordFrequencies(doc_id)) {
-            doc_words.insert(i.first);
-        }
-        if (word_sets.count(doc_words) == 0) {
-            word_sets.insert(doc_words);
-        }
-        else {
-            ids_to_remove.push_back(doc_id);
-        }
-        doc_words.clear();
-    }
-
-    for (int id : ids_to_remove) {
-        search_server.RemoveDocument(id);
-        std::cout << "Found duplicate document id " << id << std::endl;
-    }
-}
+#include "remove_duplicates.h"
+
+#include <vector>
+#include <iostream>
+
+void RemoveDuplicates(SearchServer& search_server) {
+    const std::vector<int> ids_to_remove = search_server.FindDuplicates(std::execution::par);
+
+    for (int id : ids_to_remove) {
+        std::cout << "Found duplicate document id " << id << '\n';
+    }
+
+    // one batch of tombstones and one compaction instead of a full removal per duplicate
+    search_server.RemoveDocuments(ids_to_remove);
+    search_server.CompactRemovedDocuments(std::execution::par);
+}
@@ -1,5 +1,5 @@
-#pragma once
-
-#include "search_server.h"
-
+#pragma once
+
+#include "search_server.h"
+
 void RemoveDuplicates(SearchServer& search_server);
\ No newline at end of file
@@ -1,23 +1,98 @@
-//#include "request_queue.h"
-
-//void RequestQueue::AddFindRequest(const std::string& raw_query, DocumentStatus stat) {
-//    return RequestQueue::AddFindRequest(raw_query,
-//        [stat](int document_id, DocumentStatus status, int rating) { return status == stat; });
-//}
-//
-//void RequestQueue::AddFindRequest(const std::string& raw_query) {
-//    return RequestQueue::AddFindRequest(raw_query, DocumentStatus::ACTUAL);
-//}
-//
-//int RequestQueue::GetNoResultRequests() const {
-//    return static_cast<int>(std::count_if(requests_.begin(), requests_.end(),
-//        [](QueryResult a) { return a.empty; }));
-//}
-//
-//void RequestQueue::AddLine(bool is_empty) {
-//    int i = requests_.empty() ? 0 : requests_.back().number + 1;
-//    QueryResult a;
-//    a.number = i;
-//    a.empty = is_empty;
-//    requests_.push_back(a);
-//}
\ No newline at end of file
+#include "request_queue.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+    const int RESULT_COUNT_BITS = 24;
+    const int LATENCY_BITS = 40;
+    const uint64_t MAX_RESULT_COUNT = (uint64_t{ 1 } << RESULT_COUNT_BITS) - 1;
+    const uint64_t MAX_LATENCY = (uint64_t{ 1 } << LATENCY_BITS) - 1;     // HINT : ~18 minutes in ns
+
+    // HINT : threads get shards round robin on their first request, so up to shard_count threads never share one
+    std::atomic<size_t> next_thread_index{ 0 };
+
+}
+
+RequestQueue::RequestQueue(const SearchServer& search_server, size_t window_size, size_t shard_count)
+    : search_server_(search_server)
+    , window_size_(window_size)
+    , shards_(shard_count) {
+    if (window_size == 0 || shard_count == 0) {
+        throw std::invalid_argument("Window and shard count must be positive");
+    }
+    // a single thread may make the whole window, so every shard can hold it
+    for (Shard& shard : shards_) {
+        shard.slots = std::make_unique<Slot[]>(window_size);
+    }
+}
+
+std::vector<Document> RequestQueue::AddFindRequest(const std::string_view raw_query, DocumentStatus stat) {
+    return AddFindRequest(raw_query,
+        [stat](int, DocumentStatus status, int) { return status == stat; });
+}
+
+std::vector<Document> RequestQueue::AddFindRequest(const std::string_view raw_query) {
+    return AddFindRequest(raw_query, DocumentStatus::ACTUAL);
+}
+
+RequestQueue::Shard& RequestQueue::ShardOfThisThread() {
+    thread_local const size_t thread_index = next_thread_index.fetch_add(1, std::memory_order_relaxed);
+    return shards_[thread_index % shards_.size()];
+}
+
+void RequestQueue::Record(size_t result_count, std::chrono::nanoseconds latency) {
+    const uint64_t results = std::min<uint64_t>(result_count, MAX_RESULT_COUNT);
+    const uint64_t nanoseconds = std::min<uint64_t>(std::max<int64_t>(latency.count(), 0), MAX_LATENCY);
+    const uint64_t time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch_).count() + 1;
+
+    // relaxed fetch_add: another thread only shares the head when there are more threads than shards
+    Shard& shard = ShardOfThisThread();
+    Slot& slot = shard.slots[shard.head.fetch_add(1, std::memory_order_relaxed) % window_size_];
+    // HINT : seqlock of one writer, readers skip the slot while time is 0 or has changed under them
+    slot.time.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.record.store((results << LATENCY_BITS) | nanoseconds, std::memory_order_relaxed);
+    slot.time.store(time, std::memory_order_release);
+}
+
+int RequestQueue::GetNoResultRequests() const {
+    return static_cast<int>(GetStats().no_result_requests);
+}
+
+RequestStats RequestQueue::GetStats() const {
+    // HINT : < time, record >
+    std::vector<std::pair<uint64_t, uint64_t>> records;
+    records.reserve(window_size_);
+    for (const Shard& shard : shards_) {
+        const size_t filled = static_cast<size_t>(std::min<uint64_t>(shard.head.load(std::memory_order_acquire), window_size_));
+        for (size_t i = 0; i < filled; ++i) {
+            const Slot& slot = shard.slots[i];
+            const uint64_t time = slot.time.load(std::memory_order_acquire);
+            const uint64_t record = slot.record.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (time != 0 && slot.time.load(std::memory_order_relaxed) == time) {
+                records.push_back({ time, record });
+            }
+        }
+    }
+    if (records.size() > window_size_) {
+        std::nth_element(records.begin(), records.begin() + window_size_, records.end(),
+            [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+        records.resize(window_size_);
+    }
+
+    RequestStats stats;
+    stats.requests = records.size();
+    for (const auto& [_, record] : records) {
+        const size_t results = static_cast<size_t>(record >> LATENCY_BITS);
+        const std::chrono::nanoseconds latency(record & MAX_LATENCY);
+        stats.no_result_requests += results == 0 ? 1 : 0;
+        stats.results += results;
+        stats.total_latency += latency;
+        stats.max_latency = std::max(stats.max_latency, latency);
+    }
+    return stats;
+}
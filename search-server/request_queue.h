@@ -1,37 +1,73 @@
-#pragma once
-
-#include <string>
-#include <deque>
-#include <algorithm>
-
-//#include "document.h"
-//#include "search_server.h"
-
-//class RequestQueue {
-//public:
-//    explicit RequestQueue(const SearchServer& search_server) : search_server_for_requests(search_server) { }
-//
-//    template <typename DocumentPredicate>
-//    void AddFindRequest(const std::string& raw_query, DocumentPredicate document_predicate) {
-//        if (!requests_.empty() && requests_.size() >= min_in_day_) {
-//            requests_.pop_front();
-//        }
-//        AddLine(search_server_for_requests.FindTopDocuments(raw_query, document_predicate).empty());
-//    }
-//
-//    void AddFindRequest(const std::string& raw_query, DocumentStatus status);
-//    void AddFindRequest(const std::string& raw_query);
-//
-//    int GetNoResultRequests() const;
-//
-//private:
-//    struct QueryResult {
-//        int number;
-//        bool empty;
-//    };
-//    std::deque<QueryResult> requests_;
-//    const static int min_in_day_ = 1440;
-//    const SearchServer& search_server_for_requests;
-//
-//    void AddLine(bool is_empty);
-//};
\ No newline at end of file
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "document.h"
+#include "search_server.h"
+
+struct RequestStats {
+    size_t requests = 0;                // in the window
+    size_t no_result_requests = 0;
+    size_t results = 0;                 // documents returned by all of them
+    std::chrono::nanoseconds total_latency{ 0 };
+    std::chrono::nanoseconds max_latency{ 0 };
+
+    double NoResultRate() const {
+        return requests == 0 ? 0.0 : static_cast<double>(no_result_requests) / requests;
+    }
+
+    std::chrono::nanoseconds MeanLatency() const {
+        return requests == 0 ? std::chrono::nanoseconds(0) : total_latency / static_cast<int64_t>(requests);
+    }
+};
+
+// Statistics of the last window_size FindTopDocuments requests, safe to use from any number of threads.
+// Every thread writes to its own shard, a lock-free ring of window_size slots with its own head,
+// so recording never touches a line written by another thread. Records carry the time they were made,
+// reading merges the shards and keeps the window_size latest. Requests recorded while stats
+// are being read may be seen or not
+class RequestQueue {
+public:
+    explicit RequestQueue(const SearchServer& search_server, size_t window_size = 1440, size_t shard_count = 32);
+
+    template <typename DocumentPredicate>
+    std::vector<Document> AddFindRequest(const std::string_view raw_query, DocumentPredicate document_predicate) {
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<Document> documents = search_server_.FindTopDocuments(raw_query, document_predicate);
+        Record(documents.size(), std::chrono::steady_clock::now() - start);
+        return documents;
+    }
+
+    std::vector<Document> AddFindRequest(const std::string_view raw_query, DocumentStatus status);
+    std::vector<Document> AddFindRequest(const std::string_view raw_query);
+
+    // for requests run elsewhere, e.g. by ProcessQueries
+    void Record(size_t result_count, std::chrono::nanoseconds latency);
+
+    int GetNoResultRequests() const;
+    RequestStats GetStats() const;
+
+private:
+    // HINT : time == 0 -> slot is empty or being written, record packs < result count : 24, latency ns : 40 >
+    struct Slot {
+        std::atomic<uint64_t> time{ 0 };
+        std::atomic<uint64_t> record{ 0 };
+    };
+
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> head{ 0 };
+        std::unique_ptr<Slot[]> slots;
+    };
+
+    const SearchServer& search_server_;
+    const size_t window_size_;
+    const std::chrono::steady_clock::time_point epoch_ = std::chrono::steady_clock::now();
+    std::vector<Shard> shards_;
+
+    Shard& ShardOfThisThread();
+};
@@ -0,0 +1,91 @@
+#include "result_cache.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace {
+
+    // HINT : rough cost of list node, hash node and bucket around every entry
+    const size_t ENTRY_OVERHEAD = 96;
+
+}
+
+ResultCache::ResultCache(size_t max_bytes, size_t shard_count)
+    : shard_max_bytes_(max_bytes / std::max<size_t>(shard_count, 1))
+    , shards_(std::max<size_t>(shard_count, 1)) {
+}
+
+ResultCache::Shard& ResultCache::ShardFor(const std::string& key) {
+    return shards_[std::hash<std::string>{}(key) % shards_.size()];
+}
+
+void ResultCache::Erase(Shard& shard, std::list<Entry>::iterator it) {
+    shard.bytes -= it->bytes;
+    bytes_ -= it->bytes;
+    --entries_;
+    shard.index.erase(it->key);
+    shard.lru.erase(it);
+}
+
+std::optional<std::vector<Document>> ResultCache::Find(const std::string& key, uint64_t generation) {
+    Shard& shard = ShardFor(key);
+    std::lock_guard lock(shard.mutex);
+    const auto found = shard.index.find(key);
+    if (found == shard.index.end()) {
+        ++misses_;
+        return std::nullopt;
+    }
+    const std::list<Entry>::iterator it = found->second;
+    if (it->generation != generation) {
+        ++misses_;
+        ++stale_;
+        Erase(shard, it);
+        return std::nullopt;
+    }
+    ++hits_;
+    shard.lru.splice(shard.lru.begin(), shard.lru, it);
+    return it->documents;
+}
+
+void ResultCache::Insert(std::string key, uint64_t generation, std::vector<Document> documents) {
+    const size_t bytes = ENTRY_OVERHEAD + key.capacity() + documents.capacity() * sizeof(Document);
+    if (bytes > shard_max_bytes_) {
+        return;
+    }
+    Shard& shard = ShardFor(key);
+    std::lock_guard lock(shard.mutex);
+    const auto found = shard.index.find(key);
+    if (found != shard.index.end()) {
+        Erase(shard, found->second);
+    }
+    while (shard.bytes + bytes > shard_max_bytes_) {
+        Erase(shard, std::prev(shard.lru.end()));
+        ++evictions_;
+    }
+
+    shard.lru.push_front({ std::move(key), generation, std::move(documents), bytes });
+    shard.index.emplace(shard.lru.front().key, shard.lru.begin());
+    shard.bytes += bytes;
+    bytes_ += bytes;
+    ++entries_;
+}
+
+void ResultCache::Clear() {
+    for (Shard& shard : shards_) {
+        std::lock_guard lock(shard.mutex);
+        while (!shard.lru.empty()) {
+            Erase(shard, shard.lru.begin());
+        }
+    }
+}
+
+ResultCacheStats ResultCache::GetStats() const {
+    ResultCacheStats stats;
+    stats.hits = hits_;
+    stats.misses = misses_;
+    stats.stale = stale_;
+    stats.evictions = evictions_;
+    stats.entries = entries_;
+    stats.bytes = bytes_;
+    return stats;
+}
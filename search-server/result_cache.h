@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "document.h"
+
+struct ResultCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t stale = 0;                 // misses on an entry of an older index generation
+    uint64_t evictions = 0;
+    size_t entries = 0;
+    size_t bytes = 0;
+
+    double HitRatio() const {
+        return hits + misses == 0 ? 0.0 : static_cast<double>(hits) / (hits + misses);
+    }
+};
+
+// Results of FindTopDocuments by normalized query key. Keys are spread over shards,
+// each shard is an LRU list under its own mutex and holds max_bytes / shard_count.
+// Every entry remembers the index generation it was computed for, an entry of
+// another generation is dropped on lookup instead of being returned
+class ResultCache {
+public:
+    ResultCache(size_t max_bytes, size_t shard_count);
+
+    std::optional<std::vector<Document>> Find(const std::string& key, uint64_t generation);
+    void Insert(std::string key, uint64_t generation, std::vector<Document> documents);
+    void Clear();
+
+    ResultCacheStats GetStats() const;
+
+private:
+    struct Entry {
+        std::string key;
+        uint64_t generation = 0;
+        std::vector<Document> documents;
+        size_t bytes = 0;
+    };
+
+    // HINT : key views point into Entry::key, list nodes never move
+    struct Shard {
+        std::mutex mutex;
+        std::list<Entry> lru;                                               // most recent first
+        std::unordered_map<std::string_view, std::list<Entry>::iterator> index;
+        size_t bytes = 0;
+    };
+
+    Shard& ShardFor(const std::string& key);
+    void Erase(Shard& shard, std::list<Entry>::iterator it);
+
+private:
+    const size_t shard_max_bytes_;
+    std::vector<Shard> shards_;
+
+    std::atomic<uint64_t> hits_ = 0;
+    std::atomic<uint64_t> misses_ = 0;
+    std::atomic<uint64_t> stale_ = 0;
+    std::atomic<uint64_t> evictions_ = 0;
+    std::atomic<size_t> entries_ = 0;
+    std::atomic<size_t> bytes_ = 0;
+};
@@ -1,315 +1,1133 @@
-#include "search_server.h"
-
-/************************************ CONSTRUCTORS ************************************/
-
-SearchServer::SearchServer(const std::string_view stop_words) {
-    if (!IsValidWord(stop_words)) {
-        throw std::invalid_argument("Special symbol in constructor");
-    }
-    SetStopWords(stop_words);
-}
-
-SearchServer::SearchServer(const std::string stop_words) {
-    if (!IsValidWord(std::string_view(stop_words))) {
-        throw std::invalid_argument("Special symbol in constructor");
-    }
-    SetStopWords(stop_words);
-}
-
-/************************************ PRIVATE METHODS ************************************/
-
-void SearchServer::SetStopWords(const std::string_view text) {
-    for (const std::string_view& word : SplitIntoWords(text)) {
-        stop_words_.insert(std::string(word));
-    }
-}
-
-bool SearchServer::IsStopWord(const std::string_view word) const {
-    return stop_words_.count(std::string(word)) > 0;
-}
-
-std::vector<std::string_view> SearchServer::SplitIntoWordsNoStop(const std::string_view text) const {
-    std::vector<std::string_view> words;
-    for (const std::string_view word : SplitIntoWords(text)) {
-        if (!IsStopWord(word)) {
-            words.push_back(word);
-        }
-    }
-    return words;
-}
-
-int SearchServer::ComputeAverageRating(const std::vector<int>& ratings) {
-    if (ratings.empty()) {
-        return 0;
-    }
-    int rating_sum = std::accumulate(ratings.begin(), ratings.end(), 0);
-    return rating_sum / static_cast<int>(ratings.size());
-}
-
-SearchServer::QueryWord SearchServer::ParseQueryWord(std::string_view text) const {
-    bool is_minus = false;
-    if (text[0] == '-') {
-        is_minus = true;
-        text = text.substr(1);
-    }
-    return { text, is_minus, IsStopWord(text) };
-}
-
-SearchServer::Query SearchServer::ParseQuery(const std::string_view text, bool sort) const {
-    Query query;
-
-    for (const std::string_view& word : SplitIntoWords(text)) {
-        const QueryWord query_word = ParseQueryWord(word);
-
-        if (query_word.is_minus && query_word.word.empty()) {
-            throw std::invalid_argument("No word after minus in ParseQuery()");
-        }
-        if (query_word.is_minus && query_word.word[0] == '-') {
-            throw std::invalid_argument("Double minus in ParseQuery()");
-        }
-        if (!IsValidWord(query_word.word)) {
-            throw std::invalid_argument("Special symbol in ParseQuery()");
-        }
-
-        if (!query_word.is_stop) {
-            if (query_word.is_minus) {
-                query.minus_words.push_back(query_word.word);              // string_view
-            }
-            else {
-                query.plus_words.push_back(query_word.word);              // string_view
-            }
-        }
-    }
-
-    if (sort) {
-        std::sort(
-            std::execution::par,
-            query.plus_words.begin(), query.plus_words.end()
-        );
-        auto last = std::unique(
-            std::execution::par,
-            query.plus_words.begin(), query.plus_words.end()
-        );
-        query.plus_words.erase(last, query.plus_words.end());
-
-        std::sort(
-            std::execution::par,
-            query.minus_words.begin(), query.minus_words.end()
-        );
-        last = std::unique(
-            std::execution::par,
-            query.minus_words.begin(), query.minus_words.end()
-        );
-        query.minus_words.erase(last, query.minus_words.end());
-    }
-
-    return query;
-}
-
-double SearchServer::ComputeWordInverseDocumentFreq(const std::string_view word) const {
-    return std::log(GetDocumentCount() * 1.0 / word_to_document_freqs_.at(word).size());
-}
-
-bool SearchServer::IsValidWord(const std::string_view word) {
-    return std::none_of(
-        word.begin(), word.end(),
-        [](const char& c) {
-            return c >= '\0' && c < ' ';
-        });
-}
-
-/************************************ PUBLIC METHODS ************************************/
-
-void SearchServer::AddDocument(int document_id, const std::string_view content, DocumentStatus status, const std::vector<int>& ratings) {
-    if (document_id < 0) {
-        throw std::invalid_argument("Negative ID");
-    }
-    if (documents_.count(document_id)) {
-        throw std::invalid_argument("ID already exist");
-    }
-    if (!IsValidWord(content)) {
-        throw std::invalid_argument("Special symbol in AddDocument");
-    }
-
-    ids_.insert(document_id);
-
-    documents_.emplace(document_id, DocumentData{ ComputeAverageRating(ratings), status, std::string(content) });
-
-    const std::vector<std::string_view> words = SplitIntoWordsNoStop(std::string_view(documents_.at(document_id).content));
-    const double inv_word_count = 1.0 / words.size();
-    for (const std::string_view word : words) {
-        word_to_document_freqs_[word][document_id] += inv_word_count;
-        words_freqs_overall_[document_id].emplace(word, word_to_document_freqs_[word][document_id]);
-    }
-}
-
-int SearchServer::GetDocumentCount() const {
-    return static_cast<int>(documents_.size());
-}
-
-std::tuple<std::vector<std::string_view>, DocumentStatus> SearchServer::MatchDocument(const std::string_view raw_query, int document_id) const {
-    return MatchDocument(std::execution::seq, raw_query, document_id);
-}
-
-std::tuple<std::vector<std::string_view>, DocumentStatus> SearchServer::MatchDocument(
-    const std::execution::sequenced_policy& policy, const std::string_view raw_query, int document_id) const {
-    const Query query = ParseQuery(raw_query, true);
-    //const QueryS query = ParseQueryS(raw_query, true);
-    std::vector<std::string_view> matched_words;
-
-    for (const std::string_view word : query.minus_words) {
-        if (word_to_document_freqs_.count(word) == 0) {     // if no word in document. For .at() safety
-            continue;
-        }
-        if (word_to_document_freqs_.at(word).count(document_id)) {
-            matched_words.clear();
-            return std::make_tuple(matched_words, documents_.at(document_id).status);
-        }
-    }
-
-    for (const std::string_view word : query.plus_words) {
-        if (word_to_document_freqs_.count(word) == 0) {
-            continue;
-        }
-        if (word_to_document_freqs_.at(word).count(document_id)) {
-            matched_words.push_back(word);
-        }
-    }
-
-    return std::make_tuple(matched_words, documents_.at(document_id).status);
-}
-
-std::tuple<std::vector<std::string_view>, DocumentStatus> SearchServer::MatchDocument(
-    const std::execution::parallel_policy& policy, const std::string_view raw_query, int document_id) const {
-
-    if (ids_.count(document_id) == 0)
-        throw std::out_of_range("Invalid ID\n");
-
-    Query query = ParseQuery(raw_query, false);      // QueryV - struct of two vectors
-    std::vector<std::string_view> matched_words;
-    const std::map<std::string_view, double>& InMap = words_freqs_overall_.at(document_id);      // all words of this document
-
-    // return if minus word exists
-    if (std::any_of(
-        std::execution::par,
-        query.minus_words.begin(), query.minus_words.end(),
-        [&](const std::string_view word) {
-            return InMap.count(word);
-        }
-    )) {
-        //matched_words.clear();
-        return std::make_tuple(matched_words, documents_.at(document_id).status);
-    }
-
-    // unique words in document
-    //matched_words.resize(InMap.size());
-    matched_words.resize(query.plus_words.size());
-
-    // filling matched_words
-    std::vector<std::string_view>::iterator It = std::copy_if(
-        std::execution::par,
-        query.plus_words.begin(), query.plus_words.end(),
-        matched_words.begin(),                                          // Implicitly cast string to string_view?
-        [&](const std::string_view word) {
-            //return InMap.count(word);
-            return word_to_document_freqs_.at(word).count(document_id);
-        }
-    );
-    matched_words.erase(It, matched_words.end());
-
-    std::sort(
-        std::execution::par,
-        matched_words.begin(), matched_words.end()
-    );
-    auto last = std::unique(
-        std::execution::par,
-        matched_words.begin(), matched_words.end()
-    );
-    matched_words.erase(last, matched_words.end());
-
-    return std::make_tuple(matched_words, documents_.at(document_id).status);
-}
-
-void SearchServer::RemoveDocument(int document_id) {
-    if (ids_.count(document_id) == 0) return;
-    SearchServer::RemoveDocument(std::execution::seq, document_id);
-}
-
-void SearchServer::RemoveDocument(const std::execution::sequenced_policy& policy, int document_id) {
-    if (ids_.count(document_id) == 0) return;
-
-    for (auto [word, _] : GetWordFrequencies(document_id)) {
-        word_to_document_freqs_.at(std::string(word)).erase(document_id);
-    }
-
-    if (documents_.count(document_id)) {
-        documents_.erase(document_id);
-    }
-
-    ids_.erase(document_id);
-
-    words_freqs_overall_.erase(document_id);
-}
-
-void SearchServer::RemoveDocument(const std::execution::parallel_policy& policy, int document_id) {
-    if (ids_.count(document_id) == 0) return;
-
-    // vector for words in document to be removed
-    const std::map<std::string_view, double>& InMap = words_freqs_overall_.at(document_id);
-    std::vector<const std::string_view*> tmp(InMap.size());
-
-    // filling temporary vector
-    std::transform(std::execution::par,
-        InMap.begin(), InMap.end(),
-        tmp.begin(),
-        [](const /*std::pair<std::string, double>*/auto& i) {       // WHY std::pair causes UB?
-            return &i.first;
-        });
-
-    // removing doc_ids for each word
-    std::for_each(std::execution::par,
-        tmp.begin(), tmp.end(),
-        [&](const std::string_view* word) {
-            word_to_document_freqs_.at(*word).erase(document_id);
-        }
-        );
-
-    //  others
-    if (documents_.count(document_id)) {
-        documents_.erase(document_id);
-    }
-
-    ids_.erase(document_id);
-
-    words_freqs_overall_.erase(document_id);
-}
-
-const std::map<std::string_view, double> SearchServer::GetWordFrequencies(int document_id) const {
-    std::map<std::string_view, double> ret;
-    if (words_freqs_overall_.count(document_id) != 0) {
-        for (const auto& word : words_freqs_overall_.at(document_id)) {
-            ret.emplace(std::string_view(word.first), word.second);
-        }
-    }
-    return ret;
-}
-
-std::vector<Document> SearchServer::FindTopDocuments(const std::string_view raw_query, DocumentStatus stat) const {
-    return FindTopDocuments(std::execution::seq, raw_query, [stat](int document_id, DocumentStatus status, int rating) { return status == stat; });
-}
-
-std::vector<Document> SearchServer::FindTopDocuments(const std::string_view raw_query) const {
-    return FindTopDocuments(std::execution::seq, raw_query, [](int document_id, DocumentStatus status, int rating) { return status == DocumentStatus::ACTUAL; });
-}
-
-
-
-/************************************ ITERATORS ************************************/
-
-std::set<int>::const_iterator SearchServer::begin() {
-    return ids_.begin();
-}
-
-std::set<int>::const_iterator SearchServer::end() {
-    return ids_.end();
-}
\ No newline at end of file
+#include "search_server.h"
+#include "write_ahead_log.h"
+
+/************************************ CONSTRUCTORS ************************************/
+
+SearchServer::SearchServer(const std::string_view stop_words, std::pmr::memory_resource* resource)
+    : resource_(resource) {
+    if (!IsValidWord(stop_words)) {
+        throw std::invalid_argument("Special symbol in constructor");
+    }
+    SetStopWords(stop_words);
+}
+
+SearchServer::SearchServer(const std::string stop_words, std::pmr::memory_resource* resource)
+    : resource_(resource) {
+    if (!IsValidWord(std::string_view(stop_words))) {
+        throw std::invalid_argument("Special symbol in constructor");
+    }
+    SetStopWords(stop_words);
+}
+
+/************************************ PRIVATE METHODS ************************************/
+
+void SearchServer::SetStopWords(const std::string_view text) {
+    // stop words are normalized like document words, otherwise they would never match
+    std::vector<char> buffer;
+    for (const std::string_view word : SplitIntoWordsLazy(FoldCase(text, buffer), "Special symbol in constructor")) {
+        const std::string_view term = TrimPunctuation(word);
+        if (!term.empty()) {
+            stop_words_.emplace(term);
+        }
+    }
+}
+
+bool SearchServer::IsStopWord(const std::string_view word) const {
+    return stop_words_.count(word) > 0;
+}
+
+std::string_view SearchServer::ToTerm(const std::string_view word) const {
+    const std::string_view term = TrimPunctuation(word);
+    return IsStopWord(term) ? std::string_view() : term;
+}
+
+int SearchServer::ComputeAverageRating(const std::vector<int>& ratings) {
+    if (ratings.empty()) {
+        return 0;
+    }
+    int rating_sum = std::accumulate(ratings.begin(), ratings.end(), 0);
+    return rating_sum / static_cast<int>(ratings.size());
+}
+
+SearchServer::Query SearchServer::ParseQuery(const std::string_view text, bool sort, std::pmr::memory_resource* resource) const {
+    return ParseQueryText(text, [this](const std::string_view word) { return IsStopWord(word); }, sort, resource);
+}
+
+double SearchServer::ComputeWordInverseDocumentFreq(const std::string_view word) const {
+    // postings keep removed documents until compaction, so both counts include them
+    return std::log(documents_.size() * 1.0 / word_to_document_freqs_.at(word).size());
+}
+
+void SearchServer::ResolveQuery(const Query& query, ResolvedQuery& resolved) const {
+    resolved.plus_terms.reserve(query.plus_words.size());
+    for (size_t slot = 0; slot < query.plus_words.size(); ++slot) {
+        const auto it = word_to_document_freqs_.find(query.plus_words[slot]);
+        if (it != word_to_document_freqs_.end()) {
+            resolved.plus_terms.push_back({ it->first, &it->second, ComputeWordInverseDocumentFreq(it->first),
+                dictionary_.find(it->first)->second, static_cast<uint32_t>(slot) });
+        }
+    }
+    for (const std::string_view word : query.minus_words) {
+        const auto it = word_to_document_freqs_.find(word);
+        if (it != word_to_document_freqs_.end()) {
+            resolved.minus_terms.push_back({ it->first, &it->second, 0.0, dictionary_.find(word)->second });
+        }
+    }
+
+    // ids follow first appearance of words in the index, not word order
+    std::pmr::vector<QueryTerm> by_id(resolved.plus_terms.begin(), resolved.plus_terms.end(), resolved.plus_ids.get_allocator());
+    std::sort(by_id.begin(), by_id.end(),
+        [](const QueryTerm& lhs, const QueryTerm& rhs) { return lhs.id < rhs.id; });
+    by_id.erase(std::unique(by_id.begin(), by_id.end(),
+        [](const QueryTerm& lhs, const QueryTerm& rhs) { return lhs.id == rhs.id; }), by_id.end());
+    resolved.plus_ids.reserve(by_id.size());
+    resolved.plus_id_words.reserve(by_id.size());
+    resolved.plus_id_slots.reserve(by_id.size());
+    for (const QueryTerm& term : by_id) {
+        resolved.plus_ids.push_back(term.id);
+        resolved.plus_id_words.push_back(term.word);
+        resolved.plus_id_slots.push_back(term.slot);
+    }
+
+    resolved.minus_ids.reserve(resolved.minus_terms.size());
+    for (const QueryTerm& term : resolved.minus_terms) {
+        resolved.minus_ids.push_back(term.id);
+    }
+    std::sort(resolved.minus_ids.begin(), resolved.minus_ids.end());
+    resolved.minus_ids.erase(std::unique(resolved.minus_ids.begin(), resolved.minus_ids.end()), resolved.minus_ids.end());
+}
+
+const SearchServer::ResolvedQuery& SearchServer::FreshTerms(const PreparedQuery& query, std::shared_ptr<const PreparedQuery::Refreshed>& holder) const {
+    if (query.generation_ == generation_) {
+        return query.terms_;
+    }
+    // other runs of the same stale query wait for this resolution instead of making their own
+    std::lock_guard lock(*query.refresh_mutex_);
+    if (query.refreshed_ == nullptr || query.refreshed_->generation != generation_) {
+        auto refreshed = std::make_shared<PreparedQuery::Refreshed>();
+        refreshed->generation = generation_;
+        ResolveQuery(query.query_, refreshed->terms);
+        query.refreshed_ = std::move(refreshed);
+    }
+    holder = query.refreshed_;
+    return holder->terms;
+}
+
+size_t SearchServer::IntersectTerms(const ResolvedQuery& query, const DocumentData& document, uint32_t* positions) const {
+    const std::pmr::vector<uint32_t>& term_ids = document.term_ids;
+    // positions has room for plus words only, so minus words are checked without writing
+    if (IntersectsSorted(query.minus_ids.data(), query.minus_ids.size(), term_ids.data(), term_ids.size())) {
+        return 0;
+    }
+    return IntersectSorted(query.plus_ids.data(), query.plus_ids.size(), term_ids.data(), term_ids.size(), positions);
+}
+
+size_t SearchServer::MatchTerms(const ResolvedQuery& query, const DocumentData& document, std::string_view* words, uint32_t* positions) const {
+    const size_t count = IntersectTerms(query, document, positions);
+    for (size_t i = 0; i < count; ++i) {
+        words[i] = query.plus_id_words[positions[i]];
+    }
+    std::sort(words, words + count);
+    return count;
+}
+
+bool SearchServer::IsRemoved(int document_id) const {
+    return static_cast<size_t>(document_id) < removed_.size() && removed_[document_id];
+}
+
+std::pair<std::string_view, uint32_t> SearchServer::InternWord(const std::string_view word) {
+    auto it = dictionary_.find(word);
+    if (it == dictionary_.end()) {
+        it = dictionary_.emplace(word, next_term_id_++).first;
+    }
+    return { it->first, it->second };
+}
+
+void SearchServer::DropEmptyPosting(const std::string_view word) {
+    auto posting = word_to_document_freqs_.find(word);
+    if (posting == word_to_document_freqs_.end() || !posting->second.empty()) {
+        return;
+    }
+    word_to_document_freqs_.erase(posting);
+    dictionary_.erase(dictionary_.find(word));
+}
+
+void SearchServer::PurgeDocument(int document_id) {
+    // physical removal of a single tombstoned document, without waiting for compaction
+    for (const auto& [word, _] : words_freqs_overall_.at(document_id)) {
+        word_to_document_freqs_.at(word).erase(document_id);
+        DropEmptyPosting(word);
+    }
+    words_freqs_overall_.erase(document_id);
+    documents_.erase(document_id);
+    removed_[document_id] = false;
+    pending_removal_.erase(std::find(pending_removal_.begin(), pending_removal_.end(), document_id));
+}
+
+bool SearchServer::IsValidWord(const std::string_view word) {
+    return !HasSpecialSymbols(word);
+}
+
+void SearchServer::CheckNewDocument(int document_id) const {
+    if (document_id < 0) {
+        throw std::invalid_argument("Negative ID");
+    }
+    if (ids_.count(document_id)) {
+        throw std::invalid_argument("ID already exist");
+    }
+}
+
+void SearchServer::RegisterDocument(int document_id, const std::string_view content, DocumentStatus status, const std::vector<int>& ratings) {
+    if (IsRemoved(document_id)) {
+        PurgeDocument(document_id);
+    }
+
+    ids_.insert(document_id);
+    ++generation_;
+
+    documents_.emplace(document_id, DocumentData{ ComputeAverageRating(ratings), status, std::pmr::string(content, resource_), std::pmr::vector<uint32_t>(resource_) });
+
+    // documents made of stop words only still get a forward entry, removal relies on it
+    words_freqs_overall_[document_id];
+}
+
+void SearchServer::IndexWord(int document_id, const std::string_view content_word, double inv_word_count) {
+    const auto [word, term_id] = InternWord(content_word);
+    double& term_freq = word_to_document_freqs_[word][document_id];
+    term_freq += inv_word_count;
+    if (!words_freqs_overall_[document_id].emplace(word, term_freq).second) {
+        return;
+    }
+    documents_.at(document_id).term_ids.push_back(term_id);
+}
+
+void SearchServer::SealDocument(int document_id) {
+    std::pmr::vector<uint32_t>& term_ids = documents_.at(document_id).term_ids;
+    std::sort(term_ids.begin(), term_ids.end());
+    if (detect_duplicates_) {
+        TrackTermSet(document_id);
+    }
+}
+
+void SearchServer::IndexTokenizedDocument(const TokenizedDocument& tokenized) {
+    const NewDocument& document = tokenized.document;
+    RegisterDocument(document.id, document.content, document.status, document.ratings);
+    const double inv_word_count = 1.0 / tokenized.words.size();
+    for (const std::string_view word : tokenized.words) {
+        IndexWord(document.id, word, inv_word_count);
+    }
+    SealDocument(document.id);
+}
+
+bool SearchServer::CollectTermId(const std::string_view term, std::pmr::vector<uint32_t>& term_ids) const {
+    const auto it = dictionary_.find(term);
+    if (it == dictionary_.end()) {
+        return false;
+    }
+    term_ids.push_back(it->second);
+    return true;
+}
+
+bool SearchServer::AdmitDocument(int document_id, std::pmr::vector<uint32_t>& term_ids) {
+    std::sort(term_ids.begin(), term_ids.end());
+    term_ids.erase(std::unique(term_ids.begin(), term_ids.end()), term_ids.end());
+    const int original_id = FindTermSetOwner(term_ids);
+    if (original_id < 0) {
+        return true;
+    }
+    if (duplicate_callback_) {
+        duplicate_callback_(document_id, original_id);
+    }
+    return !reject_duplicates_;
+}
+
+bool SearchServer::AdmitTokenizedDocument(const TokenizedDocument& tokenized) {
+    if (!detect_duplicates_) {
+        return true;
+    }
+    term_id_buffer_.clear();
+    for (const std::string_view word : tokenized.words) {
+        if (!CollectTermId(word, term_id_buffer_)) {
+            return true;
+        }
+    }
+    return AdmitDocument(tokenized.document.id, term_id_buffer_);
+}
+
+int SearchServer::FindTermSetOwner(const std::pmr::vector<uint32_t>& term_ids) const {
+    const auto owners = term_set_owners_.find(FingerprintTermSet(term_ids.data(), term_ids.size()));
+    if (owners == term_set_owners_.end()) {
+        return -1;
+    }
+    // a collision of different sets shares the entry, so every owner is checked term by term
+    for (const int owner_id : owners->second) {
+        if (documents_.at(owner_id).term_ids == term_ids) {
+            return owner_id;
+        }
+    }
+    return -1;
+}
+
+void SearchServer::TrackTermSet(int document_id) {
+    const std::pmr::vector<uint32_t>& term_ids = documents_.at(document_id).term_ids;
+    term_set_owners_[FingerprintTermSet(term_ids.data(), term_ids.size())].push_back(document_id);
+}
+
+void SearchServer::UntrackTermSet(int document_id) {
+    if (!detect_duplicates_) {
+        return;
+    }
+    const std::pmr::vector<uint32_t>& term_ids = documents_.at(document_id).term_ids;
+    const auto owners = term_set_owners_.find(FingerprintTermSet(term_ids.data(), term_ids.size()));
+    std::pmr::vector<int>& ids = owners->second;
+    ids.erase(std::find(ids.begin(), ids.end(), document_id));
+    if (ids.empty()) {
+        term_set_owners_.erase(owners);
+    }
+}
+
+void SearchServer::CheckpointIfDue() {
+    if (wal_ != nullptr && wal_->CheckpointDue()) {
+        wal_->Checkpoint(*this);
+    }
+}
+
+/************************************ PUBLIC METHODS ************************************/
+
+void SearchServer::AddDocument(int document_id, const std::string_view content, DocumentStatus status, const std::vector<int>& ratings) {
+    LatencyTimer timer(GetLatencyHistogram(ServerOperation::ADD_DOCUMENT));
+    CheckNewDocument(document_id);
+    // words are scanned twice instead of being stored: the first pass counts them
+    // and meets special symbols before anything is changed
+    const std::string_view text = FoldCase(content, fold_buffer_);
+    size_t word_count = 0;
+    bool known_terms = detect_duplicates_;          // HINT : term ids are collected only while every term is known
+    term_id_buffer_.clear();
+    for (const std::string_view word : SplitIntoWordsLazy(text, "Special symbol in AddDocument")) {
+        const std::string_view term = ToTerm(word);
+        word_count += term.empty() ? 0 : 1;
+        known_terms = known_terms && (term.empty() || CollectTermId(term, term_id_buffer_));
+    }
+    if (known_terms && !AdmitDocument(document_id, term_id_buffer_)) {
+        return;
+    }
+    if (wal_ != nullptr) {
+        wal_->AppendAdd(document_id, content, status, ratings);
+    }
+    RegisterDocument(document_id, content, status, ratings);
+    const double inv_word_count = 1.0 / word_count;
+    for (const std::string_view word : SplitIntoWordsLazy(text)) {
+        const std::string_view term = ToTerm(word);
+        if (!term.empty()) {
+            IndexWord(document_id, term, inv_word_count);
+        }
+    }
+    SealDocument(document_id);
+    CheckpointIfDue();
+}
+
+SearchServer::TokenizedDocument SearchServer::TokenizeDocument(NewDocument document) const {
+    TokenizedDocument tokenized;
+    const std::string_view text = FoldCase(document.content, tokenized.folded_text);
+    for (const std::string_view word : SplitIntoWordsLazy(text, "Special symbol in AddDocument")) {
+        const std::string_view term = ToTerm(word);
+        if (!term.empty()) {
+            tokenized.words.push_back(term);
+        }
+    }
+    tokenized.document = std::move(document);
+    return tokenized;
+}
+
+bool SearchServer::AddTokenizedDocument(const TokenizedDocument& tokenized) {
+    LatencyTimer timer(GetLatencyHistogram(ServerOperation::ADD_DOCUMENT));
+    const NewDocument& document = tokenized.document;
+    CheckNewDocument(document.id);
+    if (!AdmitTokenizedDocument(tokenized)) {
+        return false;
+    }
+    if (wal_ != nullptr) {
+        wal_->AppendAdd(document.id, document.content, document.status, document.ratings);
+    }
+    IndexTokenizedDocument(tokenized);
+    CheckpointIfDue();
+    return true;
+}
+
+void SearchServer::AddDocuments(const std::execution::parallel_policy& policy, const std::vector<NewDocument>& documents) {
+    LatencyTimer timer(GetLatencyHistogram(ServerOperation::ADD_DOCUMENT));
+    // whole batch is validated first, so a bad document leaves the index untouched
+    std::set<int> batch_ids;
+    for (const NewDocument& document : documents) {
+        CheckNewDocument(document.id);
+        if (!IsValidWord(document.content)) {
+            throw std::invalid_argument("Special symbol in AddDocument");
+        }
+        if (!batch_ids.insert(document.id).second) {
+            throw std::invalid_argument("ID already exist");
+        }
+    }
+
+    // tokenizing is read-only, indexing stays sequential
+    std::vector<TokenizedDocument> tokenized(documents.size());
+    ForEachIndex(policy, documents.size(),
+        [&](size_t index) { tokenized[index] = TokenizeDocument(documents[index]); });
+
+    for (size_t i = 0; i < documents.size(); ++i) {
+        const NewDocument& document = documents[i];
+        // earlier documents of the batch are indexed already, so duplicates inside the batch are met too
+        if (!AdmitTokenizedDocument(tokenized[i])) {
+            continue;
+        }
+        if (wal_ != nullptr) {
+            wal_->AppendAdd(document.id, document.content, document.status, document.ratings);
+        }
+        IndexTokenizedDocument(tokenized[i]);
+    }
+    CheckpointIfDue();
+}
+
+int SearchServer::GetDocumentCount() const {
+    return static_cast<int>(documents_.size() - pending_removal_.size());
+}
+
+TermSetFingerprint SearchServer::GetFingerprint(int document_id) const {
+    if (IsRemoved(document_id)) {
+        throw std::out_of_range("Invalid ID\n");
+    }
+    const std::pmr::vector<uint32_t>& term_ids = documents_.at(document_id).term_ids;
+    return FingerprintTermSet(term_ids.data(), term_ids.size());
+}
+
+std::vector<int> SearchServer::FindDuplicates() const {
+    return FindDuplicatesImpl(std::execution::par);
+}
+
+std::vector<int> SearchServer::FindDuplicates(const std::execution::parallel_policy& policy) const {
+    return FindDuplicatesImpl(policy);
+}
+
+std::vector<int> SearchServer::FindDuplicates(const std::execution::sequenced_policy& policy) const {
+    return FindDuplicatesImpl(policy);
+}
+
+std::vector<SearchServer::NearDuplicate> SearchServer::FindNearDuplicates(double threshold) const {
+    return FindNearDuplicatesImpl(std::execution::par, threshold);
+}
+
+std::vector<SearchServer::NearDuplicate> SearchServer::FindNearDuplicates(const std::execution::parallel_policy& policy, double threshold) const {
+    return FindNearDuplicatesImpl(policy, threshold);
+}
+
+std::vector<SearchServer::NearDuplicate> SearchServer::FindNearDuplicates(const std::execution::sequenced_policy& policy, double threshold) const {
+    return FindNearDuplicatesImpl(policy, threshold);
+}
+
+uint64_t SearchServer::MixBandOrder(size_t band, uint32_t index) {
+    // HINT : splitmix64 finalizer, any bijection scattering neighbouring inputs would do
+    uint64_t value = (static_cast<uint64_t>(band) << 32 | index) + 0x9E3779B97F4A7C15ull;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    return value ^ (value >> 31);
+}
+
+LatencyHistogram& SearchServer::GetLatencyHistogram(ServerOperation operation) const {
+    return (*latencies_)[static_cast<size_t>(operation)];
+}
+
+LatencySummary SearchServer::GetLatencySummary(ServerOperation operation) const {
+    return GetLatencyHistogram(operation).GetSummary();
+}
+
+void SearchServer::DumpLatencies(std::ostream& output) const {
+    for (size_t operation = 0; operation < SERVER_OPERATION_COUNT; ++operation) {
+        output << static_cast<ServerOperation>(operation) << ": " << GetLatencySummary(static_cast<ServerOperation>(operation)) << '\n';
+    }
+}
+
+void SearchServer::EnableDuplicateDetection(DuplicateAction action, DuplicateCallback callback) {
+    reject_duplicates_ = action == DuplicateAction::REJECT;
+    duplicate_callback_ = std::move(callback);
+    if (detect_duplicates_) {
+        return;
+    }
+    detect_duplicates_ = true;
+    for (const int document_id : ids_) {
+        TrackTermSet(document_id);
+    }
+}
+
+void SearchServer::DisableDuplicateDetection() {
+    detect_duplicates_ = false;
+    duplicate_callback_ = nullptr;
+    term_set_owners_.clear();
+}
+
+std::tuple<std::vector<std::string_view>, DocumentStatus> SearchServer::MatchDocument(const std::string_view raw_query, int document_id) const {
+    return MatchDocument(std::execution::seq, raw_query, document_id);
+}
+
+std::tuple<std::vector<std::string_view>, DocumentStatus> SearchServer::MatchDocument(
+    const std::execution::sequenced_policy& policy, const std::string_view raw_query, int document_id) const {
+    LatencyTimer timer(GetLatencyHistogram(ServerOperation::MATCH_DOCUMENT));
+    if (IsRemoved(document_id))
+        throw std::out_of_range("Invalid ID\n");
+
+    QueryArenaScope arena;
+    const Query query = ParseQuery(raw_query, true, arena.Resource());
+    ResolvedQuery terms(arena.Resource());
+    ResolveQuery(query, terms);
+    const DocumentData& document = documents_.at(document_id);
+
+    // matched words are the dictionary's, query words may live in query.folded_text
+    std::vector<std::string_view> matched_words(terms.plus_ids.size());
+    std::pmr::vector<uint32_t> positions(terms.plus_ids.size(), arena.Resource());
+    matched_words.resize(MatchTerms(terms, document, matched_words.data(), positions.data()));
+    return std::make_tuple(matched_words, document.status);
+}
+
+std::tuple<std::vector<std::string_view>, DocumentStatus> SearchServer::MatchDocument(const PreparedQuery& query, int document_id) const {
+    LatencyTimer timer(GetLatencyHistogram(ServerOperation::MATCH_DOCUMENT));
+    if (IsRemoved(document_id))
+        throw std::out_of_range("Invalid ID\n");
+
+    QueryArenaScope arena;
+    std::shared_ptr<const PreparedQuery::Refreshed> holder;
+    const ResolvedQuery& terms = FreshTerms(query, holder);
+    const DocumentData& document = documents_.at(document_id);
+
+    std::vector<std::string_view> matched_words(terms.plus_ids.size());
+    std::pmr::vector<uint32_t> positions(terms.plus_ids.size(), arena.Resource());
+    matched_words.resize(MatchTerms(terms, document, matched_words.data(), positions.data()));
+    return std::make_tuple(matched_words, document.status);
+}
+
+std::tuple<size_t, DocumentStatus> SearchServer::MatchDocument(const PreparedQuery& query, int document_id, uint32_t* positions) const {
+    LatencyTimer timer(GetLatencyHistogram(ServerOperation::MATCH_DOCUMENT));
+    if (IsRemoved(document_id))
+        throw std::out_of_range("Invalid ID\n");
+
+    // a fresh query is used as it is, a stale one once resolved again for this generation
+    std::shared_ptr<const PreparedQuery::Refreshed> holder;
+    const ResolvedQuery& terms = FreshTerms(query, holder);
+    const DocumentData& document = documents_.at(document_id);
+
+    // plus_ids positions are mapped to slots in place, slot order is word order
+    const size_t count = IntersectTerms(terms, document, positions);
+    for (size_t i = 0; i < count; ++i) {
+        positions[i] = terms.plus_id_slots[positions[i]];
+    }
+    std::sort(positions, positions + count);
+    return std::make_tuple(count, document.status);
+}
+
+SearchServer::MatchedDocuments SearchServer::MatchDocuments(const std::string_view raw_query, const std::vector<int>& document_ids) const {
+    return MatchDocumentsImpl(std::execution::par, raw_query, document_ids);
+}
+
+SearchServer::MatchedDocuments SearchServer::MatchDocuments(
+    const std::execution::parallel_policy& policy, const std::string_view raw_query, const std::vector<int>& document_ids) const {
+    return MatchDocumentsImpl(policy, raw_query, document_ids);
+}
+
+SearchServer::MatchedDocuments SearchServer::MatchDocuments(
+    const std::execution::sequenced_policy& policy, const std::string_view raw_query, const std::vector<int>& document_ids) const {
+    return MatchDocumentsImpl(policy, raw_query, document_ids);
+}
+
+std::tuple<std::vector<std::string_view>, DocumentStatus> SearchServer::MatchDocument(
+    const std::execution::parallel_policy& policy, const std::string_view raw_query, int document_id) const {
+
+    if (ids_.count(document_id) == 0)
+        throw std::out_of_range("Invalid ID\n");
+
+    // one intersection of two short sorted arrays, nothing left worth splitting between threads
+    return MatchDocument(std::execution::seq, raw_query, document_id);
+}
+
+void SearchServer::RemoveDocument(int document_id) {
+    if (ids_.count(document_id) == 0) return;
+    SearchServer::RemoveDocument(std::execution::seq, document_id);
+}
+
+void SearchServer::RemoveDocument(const std::execution::sequenced_policy& policy, int document_id) {
+    LatencyTimer timer(GetLatencyHistogram(ServerOperation::REMOVE_DOCUMENT));
+    if (ids_.count(document_id) == 0) return;
+    ++generation_;
+    if (wal_ != nullptr) {
+        wal_->AppendRemove(document_id);
+    }
+    UntrackTermSet(document_id);
+
+    for (auto [word, _] : words_freqs_overall_.at(document_id)) {
+        word_to_document_freqs_.at(word).erase(document_id);
+        DropEmptyPosting(word);
+    }
+
+    if (documents_.count(document_id)) {
+        documents_.erase(document_id);
+    }
+
+    ids_.erase(document_id);
+
+    words_freqs_overall_.erase(document_id);
+    CheckpointIfDue();
+}
+
+void SearchServer::RemoveDocument(const std::execution::parallel_policy& policy, int document_id) {
+    LatencyTimer timer(GetLatencyHistogram(ServerOperation::REMOVE_DOCUMENT));
+    if (ids_.count(document_id) == 0) return;
+    ++generation_;
+    if (wal_ != nullptr) {
+        wal_->AppendRemove(document_id);
+    }
+    UntrackTermSet(document_id);
+
+    // vector for words in document to be removed
+    const std::pmr::map<std::string_view, double>& InMap = words_freqs_overall_.at(document_id);
+    std::vector<const std::string_view*> tmp(InMap.size());
+
+    // filling temporary vector
+    std::transform(
+        InMap.begin(), InMap.end(),
+        tmp.begin(),
+        [](const /*std::pair<std::string, double>*/auto& i) {       // WHY std::pair causes UB?
+            return &i.first;
+        });
+
+    // removing doc_ids for each word, every posting is a separate map
+    ForEachIndex(policy, tmp.size(),
+        [&](size_t index) {
+            word_to_document_freqs_.at(*tmp[index]).erase(document_id);
+        }
+        );
+
+    for (const std::string_view* word : tmp) {
+        DropEmptyPosting(*word);
+    }
+
+    //  others
+    if (documents_.count(document_id)) {
+        documents_.erase(document_id);
+    }
+
+    ids_.erase(document_id);
+
+    words_freqs_overall_.erase(document_id);
+    CheckpointIfDue();
+}
+
+void SearchServer::RemoveDocuments(const std::vector<int>& document_ids) {
+    LatencyTimer timer(GetLatencyHistogram(ServerOperation::REMOVE_DOCUMENT));
+    for (const int document_id : document_ids) {
+        if (ids_.count(document_id) == 0) {
+            continue;
+        }
+        if (wal_ != nullptr) {
+            wal_->AppendRemove(document_id);
+        }
+        if (removed_.size() <= static_cast<size_t>(document_id)) {
+            removed_.resize(document_id + 1);
+        }
+        removed_[document_id] = true;
+        pending_removal_.push_back(document_id);
+        UntrackTermSet(document_id);
+        ids_.erase(document_id);
+        ++generation_;
+    }
+
+    if (compaction_threshold_ > 0.0 && pending_removal_.size() > compaction_threshold_ * documents_.size()) {
+        CompactRemovedDocuments();
+    }
+    CheckpointIfDue();
+}
+
+void SearchServer::CompactRemovedDocuments() {
+    CompactRemoved(std::execution::par);
+}
+
+void SearchServer::CompactRemovedDocuments(const std::execution::parallel_policy& policy) {
+    CompactRemoved(policy);
+}
+
+void SearchServer::CompactRemovedDocuments(const std::execution::sequenced_policy& policy) {
+    CompactRemoved(policy);
+}
+
+void SearchServer::SetCompactionThreshold(double removed_share) {
+    if (removed_share < 0.0) {
+        throw std::invalid_argument("Negative compaction threshold");
+    }
+    compaction_threshold_ = removed_share;
+}
+
+void SearchServer::AttachWriteAheadLog(WriteAheadLog* wal) {
+    wal_ = wal;
+}
+
+void SearchServer::SetExecutor(Executor* executor) {
+    executor_ = executor;
+}
+
+Executor& SearchServer::GetExecutor() const {
+    return executor_ != nullptr ? *executor_ : DefaultExecutor();
+}
+
+int SearchServer::GetPendingRemovalCount() const {
+    return static_cast<int>(pending_removal_.size());
+}
+
+const std::map<std::string_view, double> SearchServer::GetWordFrequencies(int document_id) const {
+    std::map<std::string_view, double> ret;
+    if (words_freqs_overall_.count(document_id) != 0 && !IsRemoved(document_id)) {
+        for (const auto& word : words_freqs_overall_.at(document_id)) {
+            ret.emplace(std::string_view(word.first), word.second);
+        }
+    }
+    return ret;
+}
+
+std::vector<Document> SearchServer::FindTopDocuments(const std::string_view raw_query, DocumentStatus stat) const {
+    LatencyTimer timer(GetLatencyHistogram(ServerOperation::FIND_TOP_DOCUMENTS));
+    QueryArenaScope arena;
+    return FindTopByStatus(ParseQuery(raw_query, true, arena.Resource()), nullptr, stat);
+}
+
+std::vector<Document> SearchServer::FindTopDocuments(const std::string_view raw_query) const {
+    return FindTopDocuments(raw_query, DocumentStatus::ACTUAL);
+}
+
+SearchServer::PreparedQuery SearchServer::Prepare(const std::string_view raw_query) const {
+    PreparedQuery prepared;
+    prepared.raw_query_.assign(raw_query.begin(), raw_query.end());
+    // default resource on both sides, so the move keeps word views valid
+    prepared.query_ = ParseQuery(prepared.GetRawQuery(), true);
+    ResolveQuery(prepared.query_, prepared.terms_);
+    prepared.generation_ = generation_;
+    return prepared;
+}
+
+uint64_t SearchServer::GetGeneration() const {
+    return generation_;
+}
+
+std::vector<Document> SearchServer::FindTopDocuments(const PreparedQuery& query, DocumentStatus stat) const {
+    LatencyTimer timer(GetLatencyHistogram(ServerOperation::FIND_TOP_DOCUMENTS));
+    std::shared_ptr<const PreparedQuery::Refreshed> holder;
+    return FindTopByStatus(query.query_, &FreshTerms(query, holder), stat);
+}
+
+std::vector<Document> SearchServer::FindTopDocuments(const PreparedQuery& query) const {
+    return FindTopDocuments(query, DocumentStatus::ACTUAL);
+}
+
+void SearchServer::EnableResultCache(size_t max_bytes, size_t shard_count) {
+    result_cache_ = max_bytes > 0 ? std::make_unique<ResultCache>(max_bytes, shard_count) : nullptr;
+}
+
+void SearchServer::DisableResultCache() {
+    result_cache_.reset();
+}
+
+void SearchServer::EnableAsyncQueries(size_t thread_count, size_t queue_capacity, const std::vector<int>& cpus) {
+    async_pool_ = std::make_unique<ThreadPool>(thread_count, queue_capacity, cpus);
+}
+
+void SearchServer::DisableAsyncQueries() {
+    async_pool_.reset();
+}
+
+std::future<std::vector<Document>> SearchServer::FindTopDocumentsAsync(const std::string_view raw_query, DocumentStatus status) const {
+    if (async_pool_ == nullptr) {
+        throw std::runtime_error("Async queries are not enabled");
+    }
+    // packaged_task is move-only, std::function wants a copyable callable
+    auto task = std::make_shared<std::packaged_task<std::vector<Document>()>>(
+        [this, query = std::string(raw_query), status] { return FindTopDocuments(query, status); });
+    std::future<std::vector<Document>> result = task->get_future();
+    async_pool_->Submit([task] { (*task)(); });
+    return result;
+}
+
+bool SearchServer::TryFindTopDocumentsAsync(const std::string_view raw_query, DocumentStatus status, AsyncQueryCallback callback) const {
+    if (async_pool_ == nullptr) {
+        throw std::runtime_error("Async queries are not enabled");
+    }
+    ThreadPool::Task task = [this, query = std::string(raw_query), status, callback = std::move(callback)] {
+        std::vector<Document> documents;
+        std::exception_ptr error;
+        try {
+            documents = FindTopDocuments(query, status);
+        }
+        catch (...) {
+            error = std::current_exception();
+        }
+        try {
+            callback(std::move(documents), error);
+        }
+        catch (...) {
+            // nobody is left to report it to
+        }
+    };
+    return async_pool_->TrySubmit(task);
+}
+
+ResultCacheStats SearchServer::GetResultCacheStats() const {
+    return result_cache_ != nullptr ? result_cache_->GetStats() : ResultCacheStats{};
+}
+
+std::vector<Document> SearchServer::FindTopByStatus(const Query& query, const ResolvedQuery* resolved, DocumentStatus status) const {
+    std::string key;
+    if (result_cache_ != nullptr) {
+        key = MakeCacheKey(query, status);
+        if (std::optional<std::vector<Document>> cached = result_cache_->Find(key, generation_)) {
+            return std::move(*cached);
+        }
+    }
+
+    QueryArenaScope arena;
+    ResolvedQuery storage(arena.Resource());
+    if (resolved == nullptr) {
+        ResolveQuery(query, storage);
+        resolved = &storage;
+    }
+    std::vector<Document> documents = FindTopResolved(std::execution::seq, *resolved,
+        [status](int, DocumentStatus document_status, int) { return document_status == status; },
+        arena.Resource());
+
+    if (result_cache_ != nullptr) {
+        result_cache_->Insert(std::move(key), generation_, documents);
+    }
+    return documents;
+}
+
+void SearchServer::FindTopDocumentsShared(const std::vector<std::string>& raw_queries, DocumentStatus status, const BatchQueryCallback& callback) const {
+    // everything is parsed first, so an invalid query throws before any result
+    std::vector<Query> queries(raw_queries.size());
+    std::vector<std::string> keys(raw_queries.size());
+    ForEachIndex(std::execution::par, raw_queries.size(),
+        [&](size_t index) {
+            queries[index] = ParseQuery(raw_queries[index], true);
+            keys[index] = MakeCacheKey(queries[index], status);
+        });
+
+    // HINT : unique_of[i] -> position of i-th query in unique_queries
+    std::vector<size_t> unique_of(raw_queries.size());
+    std::vector<const Query*> unique_queries;
+    {
+        std::unordered_map<std::string_view, size_t> seen;
+        seen.reserve(raw_queries.size());
+        for (size_t index = 0; index < raw_queries.size(); ++index) {
+            const auto [it, inserted] = seen.emplace(keys[index], unique_queries.size());
+            if (inserted) {
+                unique_queries.push_back(&queries[index]);
+            }
+            unique_of[index] = it->second;
+        }
+    }
+
+    std::vector<std::vector<Document>> results(unique_queries.size());
+    const size_t chunk_count = (unique_queries.size() + SHARED_SCAN_CHUNK_SIZE - 1) / SHARED_SCAN_CHUNK_SIZE;
+    ForEachIndex(std::execution::par, chunk_count,
+        [&](size_t chunk) {
+            const size_t begin = chunk * SHARED_SCAN_CHUNK_SIZE;
+            const size_t end = std::min(begin + SHARED_SCAN_CHUNK_SIZE, unique_queries.size());
+            const std::vector<const Query*> chunk_queries(unique_queries.begin() + begin, unique_queries.begin() + end);
+            std::vector<std::vector<Document>> chunk_results(chunk_queries.size());
+            ScanShared(chunk_queries, status, chunk_results);
+            std::move(chunk_results.begin(), chunk_results.end(), results.begin() + begin);
+        });
+
+    ForEachIndex(std::execution::par, raw_queries.size(),
+        [&](size_t index) { callback(index, results[unique_of[index]]); });
+}
+
+void SearchServer::ScanShared(const std::vector<const Query*>& queries, DocumentStatus status, std::vector<std::vector<Document>>& results) const {
+    std::vector<SharedScanEntry> entries;
+    for (size_t index = 0; index < queries.size(); ++index) {
+        ResolvedQuery resolved;
+        ResolveQuery(*queries[index], resolved);
+        for (const QueryTerm& term : resolved.plus_terms) {
+            entries.push_back({ term.word, term.postings, term.inverse_document_freq, static_cast<uint32_t>(index), false });
+        }
+        for (const QueryTerm& term : resolved.minus_terms) {
+            entries.push_back({ term.word, term.postings, 0.0, static_cast<uint32_t>(index), true });
+        }
+    }
+    std::sort(entries.begin(), entries.end(),
+        [](const SharedScanEntry& lhs, const SharedScanEntry& rhs) {
+            return std::tie(lhs.word, lhs.is_minus, lhs.query) < std::tie(rhs.word, rhs.is_minus, rhs.query);
+        });
+
+    // HINT : group_begin[g] .. group_begin[g + 1] -> members of g-th group, a group is one posting list for all its queries
+    std::vector<const SharedScanEntry*> groups;
+    std::vector<size_t> group_begin;
+    for (size_t index = 0; index < entries.size(); ++index) {
+        if (index == 0 || entries[index].word != entries[index - 1].word || entries[index].is_minus != entries[index - 1].is_minus) {
+            groups.push_back(&entries[index]);
+            group_begin.push_back(index);
+        }
+    }
+    group_begin.push_back(entries.size());
+
+    // all posting lists of the chunk are walked together by document id, each exactly once. Removed documents
+    // and documents of another status are dropped once for every query. A document's groups come out in word
+    // order, so every query adds its terms in word order starting from zero, as FindTopDocuments does,
+    // and relevances are bit for bit the same
+    using Cursor = std::pair<int, uint32_t>;           // HINT : < current document id, group >
+    std::priority_queue<Cursor, std::vector<Cursor>, std::greater<Cursor>> cursors;
+    std::vector<std::pmr::map<int, double>::const_iterator> positions;
+    positions.reserve(groups.size());
+    for (size_t group = 0; group < groups.size(); ++group) {
+        positions.push_back(groups[group]->postings->begin());
+        if (positions[group] != groups[group]->postings->end()) {
+            cursors.push({ positions[group]->first, static_cast<uint32_t>(group) });
+        }
+    }
+
+    // HINT : state of a query in the current document: 0 -> no term yet, 1 -> plus terms only, 2 -> minus term
+    std::vector<char> states(queries.size(), 0);
+    std::vector<double> relevances(queries.size(), 0.0);
+    std::vector<uint32_t> touched;
+    while (!cursors.empty()) {
+        const int document_id = cursors.top().first;
+        const DocumentData* document = nullptr;
+        if (!IsRemoved(document_id)) {
+            const DocumentData& data = documents_.at(document_id);
+            document = data.status == status ? &data : nullptr;
+        }
+        while (!cursors.empty() && cursors.top().first == document_id) {
+            const uint32_t group = cursors.top().second;
+            cursors.pop();
+            if (document != nullptr) {
+                const double term_freq = positions[group]->second;
+                for (size_t member = group_begin[group]; member < group_begin[group + 1]; ++member) {
+                    const SharedScanEntry& entry = entries[member];
+                    if (states[entry.query] == 0) {
+                        touched.push_back(entry.query);
+                    }
+                    if (entry.is_minus) {
+                        states[entry.query] = 2;
+                    }
+                    else if (states[entry.query] != 2) {
+                        states[entry.query] = 1;
+                        relevances[entry.query] += term_freq * entry.inverse_document_freq;
+                    }
+                }
+            }
+            if (++positions[group] != groups[group]->postings->end()) {
+                cursors.push({ positions[group]->first, group });
+            }
+        }
+        for (const uint32_t query : touched) {
+            if (states[query] == 1) {
+                results[query].push_back({ document_id, relevances[query], document->rating });
+            }
+            states[query] = 0;
+            relevances[query] = 0.0;
+        }
+        touched.clear();
+    }
+
+    for (std::vector<Document>& documents : results) {
+        KeepTopDocuments(documents);
+    }
+}
+
+std::string SearchServer::MakeCacheKey(const Query& query, DocumentStatus status) {
+    // HINT : < plus words > US < minus words > US < status > US < K >, words are sorted and
+    // can't hold US (0x1F), so equal keys mean equal queries
+    std::string key;
+    for (const std::string_view word : query.plus_words) {
+        key.append(word);
+        key += ' ';
+    }
+    key += '\x1F';
+    for (const std::string_view word : query.minus_words) {
+        key.append(word);
+        key += ' ';
+    }
+    key += '\x1F';
+    key += std::to_string(static_cast<int>(status));
+    key += '\x1F';
+    key += std::to_string(MAX_RESULT_DOCUMENT_COUNT);
+    return key;
+}
+
+
+
+/************************************ SNAPSHOTS ************************************/
+
+void SearchServer::SaveSnapshot(const std::string& path) const {
+    std::string strings;
+    auto add_string = [&strings](const std::string_view text) {
+        SnapshotString ret{ strings.size(), text.size() };
+        strings.append(text);
+        return ret;
+    };
+
+    std::vector<SnapshotString> stop_words;
+    stop_words.reserve(stop_words_.size());
+    for (const std::pmr::string& word : stop_words_) {
+        stop_words.push_back(add_string(word));
+    }
+
+    // words of removed documents only are skipped, so terms are numbered after filtering
+    std::vector<SnapshotTerm> terms;
+    std::vector<SnapshotPosting> postings;
+    std::map<std::string_view, uint32_t> term_indexes;
+    terms.reserve(word_to_document_freqs_.size());
+    for (const auto& [word, freqs] : word_to_document_freqs_) {
+        SnapshotTerm term;
+        term.posting_begin = postings.size();
+        for (const auto& [document_id, term_freq] : freqs) {
+            if (!IsRemoved(document_id)) {
+                postings.push_back({ document_id, 0, term_freq });
+            }
+        }
+        term.posting_count = postings.size() - term.posting_begin;
+        if (term.posting_count == 0) {
+            continue;
+        }
+        term.text = add_string(word);
+        term_indexes.emplace_hint(term_indexes.end(), word, static_cast<uint32_t>(terms.size()));
+        terms.push_back(term);
+    }
+
+    std::vector<SnapshotDocument> documents;
+    std::vector<SnapshotForward> forward;
+    documents.reserve(ids_.size());
+    for (const auto& [document_id, data] : documents_) {
+        if (IsRemoved(document_id)) {
+            continue;
+        }
+        SnapshotDocument document;
+        document.id = document_id;
+        document.rating = data.rating;
+        document.status = static_cast<int32_t>(data.status);
+        document.content = add_string(data.content);
+        document.forward_begin = forward.size();
+        for (const auto& [word, term_freq] : words_freqs_overall_.at(document_id)) {
+            forward.push_back({ term_indexes.at(word), 0, term_freq });
+        }
+        document.forward_count = forward.size() - document.forward_begin;
+        documents.push_back(document);
+    }
+
+    SnapshotWriter writer;
+    writer.WriteSection(SNAPSHOT_STRINGS, strings);
+    writer.WriteSection(SNAPSHOT_STOP_WORDS, stop_words);
+    writer.WriteSection(SNAPSHOT_TERMS, terms);
+    writer.WriteSection(SNAPSHOT_POSTINGS, postings);
+    writer.WriteSection(SNAPSHOT_DOCUMENTS, documents);
+    writer.WriteSection(SNAPSHOT_FORWARD, forward);
+    writer.Save(path);
+}
+
+void SearchServer::LoadSnapshot(const std::string& path) {
+    const std::vector<char> image = ReadSnapshotFile(path);
+    const SnapshotView view(image.data(), image.size());
+
+    // every section is sorted, so containers are filled with end() hints in linear time.
+    // Containers share resource_ with members, so moves below hand nodes over instead of copying them
+    std::pmr::set<std::pmr::string, std::less<>> stop_words(resource_);
+    const SnapshotString* stop_word = view.Section<SnapshotString>(SNAPSHOT_STOP_WORDS);
+    for (size_t i = 0; i < view.Count(SNAPSHOT_STOP_WORDS); ++i) {
+        stop_words.emplace_hint(stop_words.end(), view.Text(stop_word[i]));
+    }
+
+    // term ids are positions in the sorted terms section
+    std::pmr::map<std::pmr::string, uint32_t, std::less<>> dictionary(resource_);
+    std::pmr::map<std::string_view, std::pmr::map<int, double>> word_to_document_freqs(resource_);
+    std::vector<std::string_view> term_words(view.Count(SNAPSHOT_TERMS));
+    const SnapshotTerm* term = view.Section<SnapshotTerm>(SNAPSHOT_TERMS);
+    const SnapshotPosting* posting = view.Section<SnapshotPosting>(SNAPSHOT_POSTINGS);
+    for (size_t i = 0; i < term_words.size(); ++i) {
+        // HINT : subtraction form, begin + count of an untrusted file may wrap
+        if (term[i].posting_begin > view.Count(SNAPSHOT_POSTINGS) || term[i].posting_count > view.Count(SNAPSHOT_POSTINGS) - term[i].posting_begin) {
+            throw std::runtime_error("Snapshot posting is out of bounds");
+        }
+        term_words[i] = dictionary.emplace_hint(dictionary.end(), view.Text(term[i].text), static_cast<uint32_t>(i))->first;
+        std::pmr::map<int, double>& freqs = word_to_document_freqs.try_emplace(word_to_document_freqs.end(), term_words[i])->second;
+        for (uint64_t j = term[i].posting_begin; j < term[i].posting_begin + term[i].posting_count; ++j) {
+            freqs.emplace_hint(freqs.end(), posting[j].document_id, posting[j].term_freq);
+        }
+    }
+
+    std::pmr::map<int, DocumentData> documents(resource_);
+    std::pmr::map<int, std::pmr::map<std::string_view, double>> words_freqs_overall(resource_);
+    std::pmr::set<int> ids(resource_);
+    const SnapshotDocument* document = view.Section<SnapshotDocument>(SNAPSHOT_DOCUMENTS);
+    const SnapshotForward* forward = view.Section<SnapshotForward>(SNAPSHOT_FORWARD);
+    for (size_t i = 0; i < view.Count(SNAPSHOT_DOCUMENTS); ++i) {
+        if (document[i].forward_begin > view.Count(SNAPSHOT_FORWARD) || document[i].forward_count > view.Count(SNAPSHOT_FORWARD) - document[i].forward_begin) {
+            throw std::runtime_error("Snapshot forward index is out of bounds");
+        }
+        if (document[i].status < static_cast<int32_t>(DocumentStatus::ACTUAL) || document[i].status > static_cast<int32_t>(DocumentStatus::REMOVED)) {
+            throw std::runtime_error("Snapshot document status is out of range");
+        }
+        const int document_id = document[i].id;
+        ids.emplace_hint(ids.end(), document_id);
+        DocumentData& data = documents.emplace_hint(documents.end(), document_id,
+            DocumentData{ document[i].rating, static_cast<DocumentStatus>(document[i].status), std::pmr::string(view.Text(document[i].content), resource_), std::pmr::vector<uint32_t>(resource_) })->second;
+        std::pmr::map<std::string_view, double>& words = words_freqs_overall.try_emplace(words_freqs_overall.end(), document_id)->second;
+        data.term_ids.reserve(document[i].forward_count);
+        for (uint64_t j = document[i].forward_begin; j < document[i].forward_begin + document[i].forward_count; ++j) {
+            words.emplace_hint(words.end(), term_words.at(forward[j].term_index), forward[j].term_freq);
+            data.term_ids.push_back(static_cast<uint32_t>(forward[j].term_index));
+        }
+        // sorted already when forward entries follow word order, a broken file must not break intersection
+        std::sort(data.term_ids.begin(), data.term_ids.end());
+        data.term_ids.erase(std::unique(data.term_ids.begin(), data.term_ids.end()), data.term_ids.end());
+    }
+
+    ++generation_;
+    stop_words_ = std::move(stop_words);
+    dictionary_ = std::move(dictionary);
+    next_term_id_ = static_cast<uint32_t>(term_words.size());
+    word_to_document_freqs_ = std::move(word_to_document_freqs);
+    documents_ = std::move(documents);
+    words_freqs_overall_ = std::move(words_freqs_overall);
+    ids_ = std::move(ids);
+    removed_.clear();
+    pending_removal_.clear();
+
+    // term ids are renumbered, so are fingerprints
+    term_set_owners_.clear();
+    if (detect_duplicates_) {
+        for (const int document_id : ids_) {
+            TrackTermSet(document_id);
+        }
+    }
+}
+
+/************************************ ITERATORS ************************************/
+
+std::pmr::set<int>::const_iterator SearchServer::begin() {
+    return ids_.begin();
+}
+
+std::pmr::set<int>::const_iterator SearchServer::end() {
+    return ids_.end();
+}
+
+std::pmr::memory_resource* SearchServer::GetMemoryResource() const {
+    return resource_;
+}
+/************************************ FREE FUNCTIONS ************************************/
+
+std::ostream& operator<<(std::ostream& os, ServerOperation operation) {
+    switch (operation) {
+    case ServerOperation::ADD_DOCUMENT:
+        return os << "AddDocument";
+    case ServerOperation::REMOVE_DOCUMENT:
+        return os << "RemoveDocument";
+    case ServerOperation::FIND_TOP_DOCUMENTS:
+        return os << "FindTopDocuments";
+    case ServerOperation::MATCH_DOCUMENT:
+        return os << "MatchDocument";
+    case ServerOperation::PROCESS_QUERIES:
+        return os << "ProcessQueries";
+    }
+    return os;
+}
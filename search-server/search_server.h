@@ -1,256 +1,921 @@
-#pragma once
-
-#include <string>
-#include <vector>
-#include <tuple>
-#include <stdexcept>
-#include <set>
-#include <map>
-#include <numeric>
-#include <algorithm>
-#include <cmath>
-#include <execution>
-#include <iostream>
-
-#include "document.h"
-#include "string_processing.h"
-#include "concurrent_map.h"
-#include "log_duration.h"
-
-const int MAX_RESULT_DOCUMENT_COUNT = 5;
-                 
-class SearchServer {
-
-private:                // CLASS INSTANCE FIELDS
-    // HINT : map < word, map < id , freq > >
-    std::map<std::string_view, std::map<int, double>> word_to_document_freqs_;
-    // HINT : map < id , map < word , freq > > 
-    std::map<int, std::map<std::string_view, double>> words_freqs_overall_;
-    std::set<int> ids_;
-    std::set<std::string> stop_words_;      // add less<> here
-
-private:                // DOCUMENTS FIELDS
-    // HINT : struct < int rating, enum DocStatus status, string content >
-    struct DocumentData {
-        int rating = 0;
-        DocumentStatus status;
-        const std::string content;
-    };
-    // HINT : map < id, struct < rating, status, content >>
-    std::map<int, DocumentData> documents_;
-
-private:                // QUERRIES FIELDS
-    // HINT : vector <string_view> x 2
-    struct Query {
-        std::vector<std::string_view> plus_words;
-        std::vector<std::string_view> minus_words;
-    };
-
-    // HINT : struct < string_view data , bool is_minus , bool is_stop >
-    struct QueryWord {
-        std::string_view word;
-        bool is_minus = true;
-        bool is_stop = true;
-    };
-
-public:         // constructors
-
-    template<typename T>
-    explicit SearchServer(const T& stop_words_container);
-    explicit SearchServer(const std::string_view stop_words);
-    explicit SearchServer(const std::string stop_words);
-
-public:             // methods
-
-    std::set<int>::const_iterator begin();
-    std::set<int>::const_iterator end();
-
-    const std::map<std::string_view, double> GetWordFrequencies(int document_id) const;
-
-    void RemoveDocument(int document_id);
-    void RemoveDocument(const std::execution::parallel_policy& policy, int document_id);
-    void RemoveDocument(const std::execution::sequenced_policy& policy, int document_id);
-
-    void AddDocument(int document_id, const std::string_view content, DocumentStatus status, const std::vector<int>& ratings);
-
-    template <typename Predicate, typename Policy>
-    std::vector<Document> FindTopDocuments(Policy policy, const std::string_view raw_query, Predicate predicate) const;        // <- the one
-    template <typename Policy>
-    std::vector<Document> FindTopDocuments(Policy policy, const std::string_view raw_query, DocumentStatus stat) const;        // redirection
-    template <typename Policy>
-    std::vector<Document> FindTopDocuments(Policy policy, const std::string_view raw_query) const;                             // redirection
-    
-    template <typename Predicate>
-    std::vector<Document> FindTopDocuments(const std::string_view raw_query, Predicate predicate) const;                        // redirection
-    std::vector<Document> FindTopDocuments(const std::string_view raw_query, DocumentStatus stat) const;                        // redirection
-    std::vector<Document> FindTopDocuments(const std::string_view raw_query) const;                                             // redirection
-
-    int GetDocumentCount() const;
-
-    std::tuple<std::vector<std::string_view>, DocumentStatus> 
-        MatchDocument(const std::string_view raw_query, int document_id) const;
-    std::tuple<std::vector<std::string_view>, DocumentStatus> 
-        MatchDocument(const std::execution::parallel_policy& policy, const std::string_view raw_query, int document_id) const;
-    std::tuple<std::vector<std::string_view>, DocumentStatus> 
-        MatchDocument(const std::execution::sequenced_policy& policy, const std::string_view raw_query, int document_id) const;
-
-private:            // methods
-
-    void SetStopWords(const std::string_view text);
-
-    bool IsStopWord(const std::string_view word) const;
-
-    std::vector<std::string_view> SplitIntoWordsNoStop(const std::string_view text) const;
-
-    static int ComputeAverageRating(const std::vector<int>& ratings);
-
-    QueryWord ParseQueryWord(std::string_view text) const;
-    
-    Query ParseQuery(const std::string_view text, bool sort = false) const;
-
-    double ComputeWordInverseDocumentFreq(const std::string_view word) const;
-
-    // Query is QueryS or QueryV
-    template <typename Predicate>       // seq
-    std::vector<Document> FindAllDocuments(const Query& query, Predicate predicate, const std::execution::sequenced_policy& policy = std::execution::seq) const;   
-    //std::vector<Document> FindAllDocuments(const QueryS& query, Predicate predicate, const std::execution::sequenced_policy& policy = std::execution::seq) const;   
-    template <typename Predicate>       // par
-    std::vector<Document> FindAllDocuments(const Query& query, Predicate predicate, const std::execution::parallel_policy& policy) const;
-
-    static bool IsValidWord(const std::string_view word);
-
-};
-
-/************************************ TEMPLATE METHODS ************************************/
-
-template<typename T>
-SearchServer::SearchServer(const T& stop_words_container) {
-    if (stop_words_container.empty()) {
-        return;
-    }
-    
-    for (const auto word : stop_words_container) {
-        if (!IsValidWord(static_cast<std::string_view>(word))) {
-            throw std::invalid_argument("Special symbol in template constructor");
-        }
-        SetStopWords(word);
-    }
-}
-
-template<typename Predicate, typename Policy>
-std::vector<Document> SearchServer::FindTopDocuments(Policy policy, const std::string_view raw_query, Predicate predicate) const {
-
-    if constexpr (std::is_same_v<Policy, std::execution::sequenced_policy>) {
-        const Query query = ParseQuery(raw_query, true);
-
-        std::vector<Document> matched_documents = FindAllDocuments(query, predicate);
-
-        std::sort(matched_documents.begin(), matched_documents.end(),
-            [](const Document& lhs, const Document& rhs) {
-                const double DELTA = 1e-6;
-                if (std::abs(lhs.relevance - rhs.relevance) < DELTA) {
-                    return lhs.rating > rhs.rating;
-                }
-                return lhs.relevance > rhs.relevance;
-            });
-        if (matched_documents.size() > MAX_RESULT_DOCUMENT_COUNT) {
-            matched_documents.resize(MAX_RESULT_DOCUMENT_COUNT);
-        }
-        return matched_documents;
-    }
-
-    Query query = ParseQuery(raw_query, true);
-    std::vector<Document> matched_documents = FindAllDocuments(query, predicate, std::execution::par);
-
-    return matched_documents;
-}
-
-template <typename Policy>
-std::vector<Document> SearchServer::FindTopDocuments(Policy policy, const std::string_view raw_query, DocumentStatus stat) const {
-    return FindTopDocuments(policy, raw_query, [stat](int document_id, DocumentStatus status, int rating) { return status == stat; });
-}
-
-template <typename Policy>
-std::vector<Document> SearchServer::FindTopDocuments(Policy policy, const std::string_view raw_query) const {
-    return FindTopDocuments(policy, raw_query, [](int document_id, DocumentStatus status, int rating) { return status == DocumentStatus::ACTUAL; });
-}
-
-template <typename Predicate>
-std::vector<Document> SearchServer::FindTopDocuments(const std::string_view raw_query, Predicate predicate) const {
-    return FindTopDocuments(std::execution::seq, raw_query, predicate);
-}
-
-template<typename Predicate>
-std::vector<Document> SearchServer::FindAllDocuments(const Query& query, Predicate predicate, const std::execution::sequenced_policy& policy) const {
-//std::vector<Document> SearchServer::FindAllDocuments(const QueryS& query, Predicate predicate, const std::execution::sequenced_policy& policy) const {
-    std::map<int, double> document_to_relevance;
-    for (const std::string_view word : query.plus_words) {
-        if (word_to_document_freqs_.count(word) == 0) {
-            continue;
-        }
-        const double inverse_document_freq = ComputeWordInverseDocumentFreq(word);
-        for (const auto [document_id, term_freq] : word_to_document_freqs_.at(word)) {
-            const DocumentData& a = documents_.at(document_id);
-            if (predicate(document_id, a.status, a.rating)) {
-                document_to_relevance[document_id] += term_freq * inverse_document_freq;
-            }
-        }
-    }
-
-    // docs with minus-words removing
-    for (const std::string_view word : query.minus_words) {
-        if (word_to_document_freqs_.count(word) == 0) {
-            continue;
-        }
-        for (const auto [document_id, _] : word_to_document_freqs_.at(word)) {
-            document_to_relevance.erase(document_id);
-        }
-    }
-
-    std::vector<Document> matched_documents;
-    for (const auto [document_id, relevance] : document_to_relevance) {
-        matched_documents.push_back(
-            { document_id, relevance, documents_.at(document_id).rating });
-    }
-    return matched_documents;
-}
-
-template<typename Predicate> 
-std::vector<Document> SearchServer::FindAllDocuments(const Query& query, Predicate predicate, const std::execution::parallel_policy& policy) const {
-
-    ConcurrentMap<int, double> document_to_relevance(12);
-    std::for_each(
-        std::execution::par,
-        query.plus_words.begin(), query.plus_words.end(),
-        [&](const std::string_view word) {
-            if (word_to_document_freqs_.count(word) != 0) {
-                const double inverse_document_freq = ComputeWordInverseDocumentFreq(word);
-                for (const auto [document_id, term_freq] : word_to_document_freqs_.at(word)) {
-                    const DocumentData& a = documents_.at(document_id);
-                    if (predicate(document_id, a.status, a.rating)) {
-                        document_to_relevance[document_id].ref_to_value += term_freq * inverse_document_freq;
-                    }
-                }
-            }
-        });
-
-    std::map<int, double> assembled_map = document_to_relevance.BuildOrdinaryMap();
-
-    // docs with minus-words removing
-    for (const std::string_view word : query.minus_words) {
-        if (word_to_document_freqs_.count(word) == 0) {
-            continue;
-        }
-        for (const auto [document_id, _] : word_to_document_freqs_.at(word)) {
-            assembled_map.erase(document_id);
-        }
-    }
-
-    std::vector<Document> matched_documents;
-    for (const auto [document_id, relevance] : assembled_map) {
-        matched_documents.push_back(
-            { document_id, relevance, documents_.at(document_id).rating });
-    }
-    return matched_documents;
-
-}
\ No newline at end of file
+#pragma once
+
+#include <string>
+#include <vector>
+#include <array>
+#include <tuple>
+#include <stdexcept>
+#include <set>
+#include <map>
+#include <unordered_map>
+#include <limits>
+#include <numeric>
+#include <algorithm>
+#include <cmath>
+#include <execution>
+#include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <functional>
+#include <future>
+#include <queue>
+#include <mutex>
+
+#include "document.h"
+#include "string_processing.h"
+#include "concurrent_map.h"
+#include "log_duration.h"
+#include "index_snapshot.h"
+#include "result_cache.h"
+#include "query_arena.h"
+#include "paginator.h"
+#include "term_intersection.h"
+#include "executor.h"
+#include "term_fingerprint.h"
+#include "latency_histogram.h"
+
+const int MAX_RESULT_DOCUMENT_COUNT = 5;
+// HINT : unique queries evaluated together by FindTopDocumentsShared, bounds its accumulators
+const size_t SHARED_SCAN_CHUNK_SIZE = 1024;
+// HINT : LSH bucket of more documents is paired all to all only if a sample of this many pairs is mostly similar
+const size_t NEAR_DUPLICATE_BUCKET_LIMIT = 64;
+// HINT : partners of every member of a dissimilar bucket over NEAR_DUPLICATE_BUCKET_LIMIT, drawn anew in each band
+const size_t NEAR_DUPLICATE_PARTNER_COUNT = NEAR_DUPLICATE_BUCKET_LIMIT / 2;
+// HINT : candidate pairs verified by one FindNearDuplicates task
+const size_t NEAR_DUPLICATE_CHUNK_SIZE = 4096;
+
+// HINT : operations with always-on latency histograms
+enum class ServerOperation {
+    ADD_DOCUMENT,           // HINT : one sample per document, or per AddDocuments batch
+    REMOVE_DOCUMENT,        // HINT : one sample per document, or per RemoveDocuments batch
+    FIND_TOP_DOCUMENTS,
+    MATCH_DOCUMENT,
+    PROCESS_QUERIES,
+};
+const size_t SERVER_OPERATION_COUNT = 5;
+
+std::ostream& operator<<(std::ostream& os, ServerOperation operation);
+
+// sorts by relevance, then by rating, and keeps MAX_RESULT_DOCUMENT_COUNT best. Every server ranks with it
+template <typename Documents>
+void KeepTopDocuments(Documents& documents) {
+    std::sort(documents.begin(), documents.end(),
+        [](const Document& lhs, const Document& rhs) {
+            const double DELTA = 1e-6;
+            if (std::abs(lhs.relevance - rhs.relevance) < DELTA) {
+                return lhs.rating > rhs.rating;
+            }
+            return lhs.relevance > rhs.relevance;
+        });
+    if (documents.size() > MAX_RESULT_DOCUMENT_COUNT) {
+        documents.resize(MAX_RESULT_DOCUMENT_COUNT);
+    }
+}
+
+class WriteAheadLog;
+                 
+class SearchServer {
+
+private:                // CLASS INSTANCE FIELDS
+    // HINT : every index container below allocates from it, declared first to be initialized first
+    std::pmr::memory_resource* resource_ = std::pmr::get_default_resource();
+    // HINT : map < word, map < id , freq > >
+    std::pmr::map<std::string_view, std::pmr::map<int, double>> word_to_document_freqs_{ resource_ };
+    // HINT : map < id , map < word , freq > > 
+    std::pmr::map<int, std::pmr::map<std::string_view, double>> words_freqs_overall_{ resource_ };
+    std::pmr::set<int> ids_{ resource_ };
+    std::pmr::set<std::pmr::string, std::less<>> stop_words_{ resource_ };
+    // HINT : map < word, term id >, owns every indexed word, posting keys are string_views into it
+    std::pmr::map<std::pmr::string, uint32_t, std::less<>> dictionary_{ resource_ };
+    // HINT : ids of dropped words are not reused
+    uint32_t next_term_id_ = 0;
+    // HINT : bumped by every mutation, prepared queries of older generations are stale
+    uint64_t generation_ = 0;
+    // HINT : case folded content of the document being added, reused between documents
+    std::pmr::vector<char> fold_buffer_ = std::pmr::vector<char>(resource_);
+
+private:                // TOMBSTONES FIELDS
+    // HINT : removed_[id] == true -> document is hidden from queries but not compacted yet
+    std::pmr::vector<bool> removed_ = std::pmr::vector<bool>(resource_);
+    std::pmr::vector<int> pending_removal_ = std::pmr::vector<int>(resource_);
+    // HINT : compact automatically when pending share of documents_ exceeds it, 0 -> manual only
+    double compaction_threshold_ = 0.0;
+
+private:                // DURABILITY FIELDS
+    // HINT : every mutation is appended here before it is applied, nullptr -> not durable
+    WriteAheadLog* wal_ = nullptr;
+
+private:                // CACHE FIELDS
+    // HINT : FindTopDocuments results by status, nullptr -> no caching
+    std::unique_ptr<ResultCache> result_cache_;
+
+private:                // DOCUMENTS FIELDS
+    // HINT : struct < int rating, enum DocStatus status, string content, sorted term ids >
+    struct DocumentData {
+        int rating = 0;
+        DocumentStatus status;
+        std::pmr::string content;     // not const: a move into documents_ keeps its resource, a copy would not
+        std::pmr::vector<uint32_t> term_ids;
+    };
+    // HINT : map < id, struct < rating, status, content >>
+    std::pmr::map<int, DocumentData> documents_{ resource_ };
+
+private:                // DUPLICATES FIELDS
+    // HINT : map < fingerprint of term set, ids of live documents with it >, kept only while detection is on
+    std::pmr::unordered_map<TermSetFingerprint, std::pmr::vector<int>, TermSetFingerprintHasher> term_set_owners_{ resource_ };
+    bool detect_duplicates_ = false;
+    bool reject_duplicates_ = false;                            // HINT : DuplicateAction::REJECT
+    std::function<void(int, int)> duplicate_callback_;          // HINT : DuplicateCallback
+    // HINT : term ids of the document being added, reused between documents
+    std::pmr::vector<uint32_t> term_id_buffer_ = std::pmr::vector<uint32_t>(resource_);
+
+private:                // METRICS FIELDS
+    // HINT : by ServerOperation, on the heap to keep the server movable
+    std::unique_ptr<std::array<LatencyHistogram, SERVER_OPERATION_COUNT>> latencies_ = std::make_unique<std::array<LatencyHistogram, SERVER_OPERATION_COUNT>>();
+
+private:                // EXECUTION FIELDS
+    // HINT : runs every par overload, nullptr -> DefaultExecutor()
+    Executor* executor_ = nullptr;
+    // HINT : serves *Async queries, nullptr -> not enabled. Declared last to be destroyed first,
+    // so queued queries still see the whole index
+    std::unique_ptr<ThreadPool> async_pool_;
+
+private:                // QUERRIES FIELDS
+    // HINT : vector <string_view> x 2, memory of a query arena unless the query is prepared
+    using Query = ParsedQuery;
+
+    // HINT : query word found in the index, word and postings belong to the index
+    struct QueryTerm {
+        std::string_view word;
+        const std::pmr::map<int, double>* postings = nullptr;
+        double inverse_document_freq = 0.0;
+        uint32_t id = 0;
+        uint32_t slot = 0;              // HINT : position of word in Query::plus_words, plus terms only
+    };
+
+    // HINT : Query words present in the index, plus terms are sorted by word.
+    // Term ids are sorted for intersection with DocumentData::term_ids, plus_id_words[i] and
+    // plus_id_slots[i] are the word of plus_ids[i] and its position in Query::plus_words
+    struct ResolvedQuery {
+        explicit ResolvedQuery(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+            : plus_terms(resource)
+            , minus_terms(resource)
+            , plus_ids(resource)
+            , plus_id_words(resource)
+            , plus_id_slots(resource)
+            , minus_ids(resource) {
+        }
+
+        std::pmr::vector<QueryTerm> plus_terms;
+        std::pmr::vector<QueryTerm> minus_terms;
+        std::pmr::vector<uint32_t> plus_ids;
+        std::pmr::vector<std::string_view> plus_id_words;
+        std::pmr::vector<uint32_t> plus_id_slots;
+        std::pmr::vector<uint32_t> minus_ids;
+    };
+
+public:
+    // Query parsed and looked up once by Prepare(), then run any number of times.
+    // Terms are valid for the index generation they were resolved in, the first run of a stale
+    // query resolves it again without parsing and keeps the result for the rest of that generation.
+    // Runs may share a query from any number of threads. Move-only: words point into it
+    class PreparedQuery {
+    public:
+        PreparedQuery(PreparedQuery&&) = default;
+        PreparedQuery& operator=(PreparedQuery&&) = default;
+        PreparedQuery(const PreparedQuery&) = delete;
+        PreparedQuery& operator=(const PreparedQuery&) = delete;
+
+        std::string_view GetRawQuery() const {
+            return std::string_view(raw_query_.data(), raw_query_.size());
+        }
+
+        // generation of the latest resolution
+        uint64_t GetGeneration() const {
+            std::lock_guard lock(*refresh_mutex_);
+            return refreshed_ != nullptr ? refreshed_->generation : generation_;
+        }
+
+        // parsed plus words, sorted and unique, positions given by span MatchDocument index it
+        const std::pmr::vector<std::string_view>& GetPlusWords() const {
+            return query_.plus_words;
+        }
+
+    private:
+        friend class SearchServer;
+        PreparedQuery() = default;
+
+        struct Refreshed {
+            uint64_t generation = 0;
+            ResolvedQuery terms;
+        };
+
+        std::vector<char> raw_query_;
+        Query query_;
+        ResolvedQuery terms_;
+        uint64_t generation_ = 0;
+        // HINT : runs hold the shared_ptr, so a resolution replaced by another thread stays alive under them
+        mutable std::unique_ptr<std::mutex> refresh_mutex_ = std::make_unique<std::mutex>();
+        mutable std::shared_ptr<const Refreshed> refreshed_;
+    };
+
+public:
+    // HINT : struct < int id, string_view content, enum DocStatus status, vector<int> ratings >
+    struct NewDocument {
+        int id = 0;
+        std::string_view content;
+        DocumentStatus status = DocumentStatus::ACTUAL;
+        std::vector<int> ratings;
+    };
+
+    // HINT : document split into terms out of the server, terms point into document.content or folded_text
+    struct TokenizedDocument {
+        NewDocument document;
+        std::vector<std::string_view> words;
+        std::vector<char> folded_text;
+    };
+
+    // HINT : matched words of many documents back to back, i-th document owns words[offsets[i], offsets[i + 1])
+    struct MatchedDocuments {
+        std::vector<std::string_view> words;
+        std::vector<size_t> offsets;
+        std::vector<DocumentStatus> statuses;
+
+        size_t Size() const {
+            return statuses.size();
+        }
+
+        IteratorRange<std::vector<std::string_view>::const_iterator> Words(size_t index) const {
+            return { words.begin() + offsets[index], words.begin() + offsets[index + 1] };
+        }
+    };
+
+    // HINT : what AddDocument does with a document whose set of terms is already indexed
+    enum class DuplicateAction {
+        REPORT,         // indexed anyway
+        REJECT,         // dropped, not logged to WAL either
+    };
+
+    // HINT : (new document id, id of live document with the same terms)
+    using DuplicateCallback = std::function<void(int, int)>;
+
+    // HINT : pair of documents whose term sets have jaccard similarity >= threshold, id < similar_id
+    struct NearDuplicate {
+        int id = 0;
+        int similar_id = 0;
+        double similarity = 0.0;
+    };
+
+public:         // constructors
+
+    // resource feeds every index container and must outlive the server
+    template<typename T>
+    explicit SearchServer(const T& stop_words_container, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    explicit SearchServer(const std::string_view stop_words, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    explicit SearchServer(const std::string stop_words, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+public:             // methods
+
+    std::pmr::set<int>::const_iterator begin();
+    std::pmr::set<int>::const_iterator end();
+
+    std::pmr::memory_resource* GetMemoryResource() const;
+
+    const std::map<std::string_view, double> GetWordFrequencies(int document_id) const;
+
+    void RemoveDocument(int document_id);
+    void RemoveDocument(const std::execution::parallel_policy& policy, int document_id);
+    void RemoveDocument(const std::execution::sequenced_policy& policy, int document_id);
+
+    // marks documents as removed right away, postings are cleaned by CompactRemovedDocuments()
+    void RemoveDocuments(const std::vector<int>& document_ids);
+    void CompactRemovedDocuments();
+    void CompactRemovedDocuments(const std::execution::parallel_policy& policy);
+    void CompactRemovedDocuments(const std::execution::sequenced_policy& policy);
+    void SetCompactionThreshold(double removed_share);
+    int GetPendingRemovalCount() const;
+
+    void AddDocument(int document_id, const std::string_view content, DocumentStatus status, const std::vector<int>& ratings);
+    // tokenizes the batch in parallel, throws before indexing anything if one document is invalid
+    void AddDocuments(const std::execution::parallel_policy& policy, const std::vector<NewDocument>& documents);
+
+    // read-only, may run concurrently with other const methods. Throws invalid_argument on special symbols
+    TokenizedDocument TokenizeDocument(NewDocument document) const;
+    // document must come from TokenizeDocument() of this server, false if duplicate detection rejected it
+    bool AddTokenizedDocument(const TokenizedDocument& document);
+
+    // mutations are logged to wal until detached with nullptr, wal must outlive the server
+    void AttachWriteAheadLog(WriteAheadLog* wal);
+
+    // par overloads run on executor until reset with nullptr, executor must outlive the server
+    void SetExecutor(Executor* executor);
+    Executor& GetExecutor() const;
+
+    template <typename Predicate, typename Policy>
+    std::vector<Document> FindTopDocuments(Policy policy, const std::string_view raw_query, Predicate predicate) const;        // <- the one
+    template <typename Policy>
+    std::vector<Document> FindTopDocuments(Policy policy, const std::string_view raw_query, DocumentStatus stat) const;        // redirection
+    template <typename Policy>
+    std::vector<Document> FindTopDocuments(Policy policy, const std::string_view raw_query) const;                             // redirection
+    
+    template <typename Predicate>
+    std::vector<Document> FindTopDocuments(const std::string_view raw_query, Predicate predicate) const;                        // redirection
+    std::vector<Document> FindTopDocuments(const std::string_view raw_query, DocumentStatus stat) const;                        // redirection
+    std::vector<Document> FindTopDocuments(const std::string_view raw_query) const;                                             // redirection
+
+    // parses and resolves raw_query against the current index generation
+    PreparedQuery Prepare(const std::string_view raw_query) const;
+    uint64_t GetGeneration() const;
+
+    template <typename Predicate, typename Policy>
+    std::vector<Document> FindTopDocuments(Policy policy, const PreparedQuery& query, Predicate predicate) const;
+    template <typename Policy>
+    std::vector<Document> FindTopDocuments(Policy policy, const PreparedQuery& query, DocumentStatus stat) const;
+    template <typename Policy>
+    std::vector<Document> FindTopDocuments(Policy policy, const PreparedQuery& query) const;
+
+    template <typename Predicate>
+    std::vector<Document> FindTopDocuments(const PreparedQuery& query, Predicate predicate) const;
+    std::vector<Document> FindTopDocuments(const PreparedQuery& query, DocumentStatus stat) const;
+    std::vector<Document> FindTopDocuments(const PreparedQuery& query) const;
+
+    // caches results of FindTopDocuments overloads filtering by status, keyed by normalized
+    // query, so "Cat  dog" and "dog cat" share an entry. Mutations make entries stale
+    void EnableResultCache(size_t max_bytes, size_t shard_count = 16);
+    void DisableResultCache();
+    ResultCacheStats GetResultCacheStats() const;
+
+    // *Async queries run on thread_count threads owned by the server, pinned to cpus if given, at most
+    // queue_capacity of them wait for a thread. Mutations and moves of the server must not overlap pending queries
+    void EnableAsyncQueries(size_t thread_count, size_t queue_capacity = 1024, const std::vector<int>& cpus = {});
+    // waits for pending queries
+    void DisableAsyncQueries();
+
+    // HINT : (documents, nullptr) or ({}, exception of the query), called on a pool thread.
+    // An exception thrown by the callback itself is dropped, it would otherwise terminate the pool thread
+    using AsyncQueryCallback = std::function<void(std::vector<Document>, std::exception_ptr)>;
+
+    // FindTopDocuments on the pool. Blocks while the queue is full, throws runtime_error if not enabled
+    std::future<std::vector<Document>> FindTopDocumentsAsync(const std::string_view raw_query, DocumentStatus status = DocumentStatus::ACTUAL) const;
+    // never blocks: false if the queue is full, callback is not called then. Throws runtime_error if not enabled
+    bool TryFindTopDocumentsAsync(const std::string_view raw_query, DocumentStatus status, AsyncQueryCallback callback) const;
+
+    // HINT : (query index, documents), called from executor threads, one result may be reported for several indices
+    using BatchQueryCallback = std::function<void(size_t, const std::vector<Document>&)>;
+
+    // FindTopDocuments(raw_queries[i], status) for every i, for big offline batches. Identical queries
+    // (same words in any order) are computed once. Unique queries are split into chunks, every chunk
+    // reads each posting list once for all of its queries. Throws before any callback if a query is invalid
+    void FindTopDocumentsShared(const std::vector<std::string>& raw_queries, DocumentStatus status, const BatchQueryCallback& callback) const;
+
+    int GetDocumentCount() const;
+
+    // hash of the set of document's terms, throws out_of_range if id is unknown or removed
+    TermSetFingerprint GetFingerprint(int document_id) const;
+
+    // ids of documents with the same set of terms as a document of lower id, in increasing order.
+    // Fingerprints are computed in parallel for par, equal ones are checked term by term
+    std::vector<int> FindDuplicates() const;
+    std::vector<int> FindDuplicates(const std::execution::parallel_policy& policy) const;
+    std::vector<int> FindDuplicates(const std::execution::sequenced_policy& policy) const;
+
+    // AddDocument, AddDocuments and AddTokenizedDocument look the term set of every incoming document up
+    // in a fingerprint table, a hit is reported to callback and then handled by action. Table is built
+    // from current documents here and follows removals and LoadSnapshot until disabled
+    void EnableDuplicateDetection(DuplicateAction action, DuplicateCallback callback = {});
+    void DisableDuplicateDetection();
+
+    // pairs of documents with jaccard similarity of term sets >= threshold in (0, 1], ordered by ids.
+    // MinHash band keys put documents into LSH buckets, only documents sharing a bucket are compared
+    // exactly, so a pair is missed with probability under 1%. A bucket over NEAR_DUPLICATE_BUCKET_LIMIT
+    // documents is compared all to all if most of a sample of its pairs pass, so big clusters come out whole.
+    // Otherwise (boilerplate) each member is compared with NEAR_DUPLICATE_PARTNER_COUNT others drawn anew
+    // in every band, and a pair sharing only such buckets may be missed. Documents without terms are skipped
+    std::vector<NearDuplicate> FindNearDuplicates(double threshold) const;
+    std::vector<NearDuplicate> FindNearDuplicates(const std::execution::parallel_policy& policy, double threshold) const;
+    std::vector<NearDuplicate> FindNearDuplicates(const std::execution::sequenced_policy& policy, double threshold) const;
+
+    // Latencies of every call of the operation since construction or Reset(). Operations built on
+    // the server, like ProcessQueries, record into it too. A batch call of AddDocuments or
+    // RemoveDocuments is one sample of the whole batch. Thread-safe
+    LatencyHistogram& GetLatencyHistogram(ServerOperation operation) const;
+    LatencySummary GetLatencySummary(ServerOperation operation) const;
+    // one line per operation, "FindTopDocuments: count 12, p50 1200 ns, ..."
+    void DumpLatencies(std::ostream& output) const;
+
+    // binary image of the whole index, see index_snapshot.h. Removed documents are not saved
+    void SaveSnapshot(const std::string& path) const;
+    // replaces stop words and every document, server is left untouched if file is broken
+    void LoadSnapshot(const std::string& path);
+
+    std::tuple<std::vector<std::string_view>, DocumentStatus> 
+        MatchDocument(const std::string_view raw_query, int document_id) const;
+    std::tuple<std::vector<std::string_view>, DocumentStatus> 
+        MatchDocument(const std::execution::parallel_policy& policy, const std::string_view raw_query, int document_id) const;
+    std::tuple<std::vector<std::string_view>, DocumentStatus> 
+        MatchDocument(const std::execution::sequenced_policy& policy, const std::string_view raw_query, int document_id) const;
+    std::tuple<std::vector<std::string_view>, DocumentStatus>
+        MatchDocument(const PreparedQuery& query, int document_id) const;
+    // MatchDocument without allocation: positions in query.GetPlusWords() of matched words are written
+    // to positions, which needs room for GetPlusWords().size() only (minus words are not written), in increasing order. Returns their count
+    std::tuple<size_t, DocumentStatus>
+        MatchDocument(const PreparedQuery& query, int document_id, uint32_t* positions) const;
+
+    // MatchDocument for every id with one parse of raw_query, results keep the order of ids.
+    // Throws out_of_range before matching anything if an id is unknown or removed
+    MatchedDocuments MatchDocuments(const std::string_view raw_query, const std::vector<int>& document_ids) const;
+    MatchedDocuments MatchDocuments(const std::execution::parallel_policy& policy, const std::string_view raw_query, const std::vector<int>& document_ids) const;
+    MatchedDocuments MatchDocuments(const std::execution::sequenced_policy& policy, const std::string_view raw_query, const std::vector<int>& document_ids) const;
+
+private:            // methods
+
+    void SetStopWords(const std::string_view text);
+
+    bool IsStopWord(const std::string_view word) const;
+
+    // word of case folded text -> index term, empty for punctuation and stop words
+    std::string_view ToTerm(const std::string_view word) const;
+
+    static int ComputeAverageRating(const std::vector<int>& ratings);
+
+    Query ParseQuery(const std::string_view text, bool sort = false, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
+
+    double ComputeWordInverseDocumentFreq(const std::string_view word) const;
+
+    // fills empty resolved, which keeps its own memory resource
+    void ResolveQuery(const Query& query, ResolvedQuery& resolved) const;
+
+    // stale prepared query is resolved again once per generation and kept in it, holder keeps the terms alive
+    const ResolvedQuery& FreshTerms(const PreparedQuery& query, std::shared_ptr<const PreparedQuery::Refreshed>& holder) const;
+
+    // positions in query.plus_ids of ids found in document, none if a minus term is in it.
+    // Sorted term ids are intersected, positions has room for plus_ids.size()
+    size_t IntersectTerms(const ResolvedQuery& query, const DocumentData& document, uint32_t* positions) const;
+
+    // matched plus words of document in word order, positions is scratch of IntersectTerms
+    size_t MatchTerms(const ResolvedQuery& query, const DocumentData& document, std::string_view* words, uint32_t* positions) const;
+
+    // HINT : resolved == nullptr -> query is resolved only on cache miss
+    std::vector<Document> FindTopByStatus(const Query& query, const ResolvedQuery* resolved, DocumentStatus status) const;
+
+    static std::string MakeCacheKey(const Query& query, DocumentStatus status);
+
+    // HINT : one term of one query of a shared scan
+    struct SharedScanEntry {
+        std::string_view word;
+        const std::pmr::map<int, double>* postings = nullptr;
+        double inverse_document_freq = 0.0;
+        uint32_t query = 0;
+        bool is_minus = false;
+    };
+
+    // top documents of every query into results, same order
+    void ScanShared(const std::vector<const Query*>& queries, DocumentStatus status, std::vector<std::vector<Document>>& results) const;
+
+    // scratch comes from resource, only the result uses the default allocator
+    template <typename Predicate, typename Policy>
+    std::vector<Document> FindTopResolved(Policy policy, const ResolvedQuery& query, Predicate predicate, std::pmr::memory_resource* resource) const;
+
+    bool IsRemoved(int document_id) const;
+
+    void CheckNewDocument(int document_id) const;
+
+    // document bookkeeping, words go through IndexWord
+    void RegisterDocument(int document_id, const std::string_view content, DocumentStatus status, const std::vector<int>& ratings);
+
+    void IndexWord(int document_id, const std::string_view word, double inv_word_count);
+
+    // sorts term ids gathered by IndexWord, called once all words of document are indexed
+    void SealDocument(int document_id);
+
+    void IndexTokenizedDocument(const TokenizedDocument& tokenized);
+
+    // HINT : false if term is new to the index, term_ids gets its id otherwise
+    bool CollectTermId(const std::string_view term, std::pmr::vector<uint32_t>& term_ids) const;
+
+    // false when the document must not be added, called before anything is changed. term_ids holds
+    // ids of all terms of the document in any order, a term new to the index makes a duplicate impossible
+    bool AdmitDocument(int document_id, std::pmr::vector<uint32_t>& term_ids);
+    bool AdmitTokenizedDocument(const TokenizedDocument& tokenized);
+
+    // HINT : live document with exactly these sorted terms, -1 if none
+    int FindTermSetOwner(const std::pmr::vector<uint32_t>& term_ids) const;
+
+    // fingerprint table follows documents that become live or stop being live
+    void TrackTermSet(int document_id);
+    void UntrackTermSet(int document_id);
+
+    void CheckpointIfDue();
+
+    // HINT : < interned word, term id >
+    std::pair<std::string_view, uint32_t> InternWord(const std::string_view word);
+
+    void DropEmptyPosting(const std::string_view word);
+
+    void PurgeDocument(int document_id);
+
+    // body(i) for every i in [0, count): in order for seq, on the executor for par
+    template <typename Policy, typename Body>
+    void ForEachIndex(Policy policy, size_t count, Body body) const;
+
+    template <typename Policy>
+    void CompactRemoved(Policy policy);
+
+    template <typename Policy>
+    std::vector<int> FindDuplicatesImpl(Policy policy) const;
+
+    template <typename Policy>
+    std::vector<NearDuplicate> FindNearDuplicatesImpl(Policy policy, double threshold) const;
+
+    // position of index-th document in the band's order of a huge LSH bucket
+    static uint64_t MixBandOrder(size_t band, uint32_t index);
+
+    template <typename Policy>
+    MatchedDocuments MatchDocumentsImpl(Policy policy, const std::string_view raw_query, const std::vector<int>& document_ids) const;
+
+    // Query is QueryS or QueryV
+    template <typename Predicate>       // seq
+    std::pmr::vector<Document> FindAllDocuments(const ResolvedQuery& query, Predicate predicate, const std::execution::sequenced_policy& policy, std::pmr::memory_resource* resource) const;   
+    //std::vector<Document> FindAllDocuments(const QueryS& query, Predicate predicate, const std::execution::sequenced_policy& policy = std::execution::seq) const;   
+    template <typename Predicate>       // par
+    std::pmr::vector<Document> FindAllDocuments(const ResolvedQuery& query, Predicate predicate, const std::execution::parallel_policy& policy, std::pmr::memory_resource* resource) const;
+
+    static bool IsValidWord(const std::string_view word);
+
+};
+
+/************************************ TEMPLATE METHODS ************************************/
+
+template<typename T>
+SearchServer::SearchServer(const T& stop_words_container, std::pmr::memory_resource* resource)
+    : resource_(resource) {
+    if (stop_words_container.empty()) {
+        return;
+    }
+    
+    for (const auto word : stop_words_container) {
+        if (!IsValidWord(static_cast<std::string_view>(word))) {
+            throw std::invalid_argument("Special symbol in template constructor");
+        }
+        SetStopWords(word);
+    }
+}
+
+template<typename Predicate, typename Policy>
+std::vector<Document> SearchServer::FindTopDocuments(Policy policy, const std::string_view raw_query, Predicate predicate) const {
+    LatencyTimer timer(GetLatencyHistogram(ServerOperation::FIND_TOP_DOCUMENTS));
+    QueryArenaScope arena;
+    const Query query = ParseQuery(raw_query, true, arena.Resource());
+    ResolvedQuery resolved(arena.Resource());
+    ResolveQuery(query, resolved);
+    return FindTopResolved(policy, resolved, predicate, arena.Resource());
+}
+
+template<typename Predicate, typename Policy>
+std::vector<Document> SearchServer::FindTopResolved(Policy, const ResolvedQuery& query, Predicate predicate, std::pmr::memory_resource* resource) const {
+
+    if constexpr (std::is_same_v<Policy, std::execution::sequenced_policy>) {
+        std::pmr::vector<Document> matched_documents = FindAllDocuments(query, predicate, std::execution::seq, resource);
+        KeepTopDocuments(matched_documents);
+        return std::vector<Document>(matched_documents.begin(), matched_documents.end());
+    }
+
+    const std::pmr::vector<Document> matched_documents = FindAllDocuments(query, predicate, std::execution::par, resource);
+
+    return std::vector<Document>(matched_documents.begin(), matched_documents.end());
+}
+
+template <typename Policy>
+std::vector<Document> SearchServer::FindTopDocuments(Policy policy, const std::string_view raw_query, DocumentStatus stat) const {
+    return FindTopDocuments(policy, raw_query, [stat](int document_id, DocumentStatus status, int rating) { return status == stat; });
+}
+
+template <typename Policy>
+std::vector<Document> SearchServer::FindTopDocuments(Policy policy, const std::string_view raw_query) const {
+    return FindTopDocuments(policy, raw_query, [](int document_id, DocumentStatus status, int rating) { return status == DocumentStatus::ACTUAL; });
+}
+
+template <typename Predicate>
+std::vector<Document> SearchServer::FindTopDocuments(const std::string_view raw_query, Predicate predicate) const {
+    return FindTopDocuments(std::execution::seq, raw_query, predicate);
+}
+
+template<typename Predicate, typename Policy>
+std::vector<Document> SearchServer::FindTopDocuments(Policy policy, const PreparedQuery& query, Predicate predicate) const {
+    LatencyTimer timer(GetLatencyHistogram(ServerOperation::FIND_TOP_DOCUMENTS));
+    QueryArenaScope arena;
+    std::shared_ptr<const PreparedQuery::Refreshed> holder;
+    return FindTopResolved(policy, FreshTerms(query, holder), predicate, arena.Resource());
+}
+
+template <typename Policy>
+std::vector<Document> SearchServer::FindTopDocuments(Policy policy, const PreparedQuery& query, DocumentStatus stat) const {
+    return FindTopDocuments(policy, query, [stat](int document_id, DocumentStatus status, int rating) { return status == stat; });
+}
+
+template <typename Policy>
+std::vector<Document> SearchServer::FindTopDocuments(Policy policy, const PreparedQuery& query) const {
+    return FindTopDocuments(policy, query, [](int, DocumentStatus status, int) { return status == DocumentStatus::ACTUAL; });
+}
+
+template <typename Predicate>
+std::vector<Document> SearchServer::FindTopDocuments(const PreparedQuery& query, Predicate predicate) const {
+    return FindTopDocuments(std::execution::seq, query, predicate);
+}
+
+template<typename Predicate>
+std::pmr::vector<Document> SearchServer::FindAllDocuments(const ResolvedQuery& query, Predicate predicate, const std::execution::sequenced_policy&, std::pmr::memory_resource* resource) const {
+//std::vector<Document> SearchServer::FindAllDocuments(const QueryS& query, Predicate predicate, const std::execution::sequenced_policy& policy) const {
+    std::pmr::map<int, double> document_to_relevance(resource);
+    for (const QueryTerm& term : query.plus_terms) {
+        for (const auto [document_id, term_freq] : *term.postings) {
+            if (IsRemoved(document_id)) {
+                continue;
+            }
+            const DocumentData& a = documents_.at(document_id);
+            if (predicate(document_id, a.status, a.rating)) {
+                document_to_relevance[document_id] += term_freq * term.inverse_document_freq;
+            }
+        }
+    }
+
+    // docs with minus-words removing
+    for (const QueryTerm& term : query.minus_terms) {
+        for (const auto [document_id, _] : *term.postings) {
+            document_to_relevance.erase(document_id);
+        }
+    }
+
+    std::pmr::vector<Document> matched_documents(resource);
+    matched_documents.reserve(document_to_relevance.size());
+    for (const auto [document_id, relevance] : document_to_relevance) {
+        matched_documents.push_back(
+            { document_id, relevance, documents_.at(document_id).rating });
+    }
+    return matched_documents;
+}
+
+template<typename Predicate> 
+std::pmr::vector<Document> SearchServer::FindAllDocuments(const ResolvedQuery& query, Predicate predicate, const std::execution::parallel_policy& policy, std::pmr::memory_resource* resource) const {
+
+    ConcurrentMap<int, double> document_to_relevance(12);
+    ForEachIndex(policy, query.plus_terms.size(),
+        [&](size_t index) {
+            const QueryTerm& term = query.plus_terms[index];
+            for (const auto [document_id, term_freq] : *term.postings) {
+                if (IsRemoved(document_id)) {
+                    continue;
+                }
+                const DocumentData& a = documents_.at(document_id);
+                if (predicate(document_id, a.status, a.rating)) {
+                    document_to_relevance[document_id].ref_to_value += term_freq * term.inverse_document_freq;
+                }
+            }
+        });
+
+    std::map<int, double> assembled_map = document_to_relevance.BuildOrdinaryMap();
+
+    // docs with minus-words removing
+    for (const QueryTerm& term : query.minus_terms) {
+        for (const auto [document_id, _] : *term.postings) {
+            assembled_map.erase(document_id);
+        }
+    }
+
+    std::pmr::vector<Document> matched_documents(resource);
+    matched_documents.reserve(assembled_map.size());
+    for (const auto [document_id, relevance] : assembled_map) {
+        matched_documents.push_back(
+            { document_id, relevance, documents_.at(document_id).rating });
+    }
+    return matched_documents;
+
+}
+
+template <typename Policy, typename Body>
+void SearchServer::ForEachIndex(Policy, size_t count, Body body) const {
+    if constexpr (std::is_same_v<std::decay_t<Policy>, std::execution::sequenced_policy>) {
+        for (size_t i = 0; i < count; ++i) {
+            body(i);
+        }
+    }
+    else {
+        GetExecutor().ParallelFor(count, body);
+    }
+}
+
+template <typename Policy>
+void SearchServer::CompactRemoved(Policy policy) {
+    if (pending_removal_.empty()) {
+        return;
+    }
+    ++generation_;
+
+    // words touched by removed documents, each posting is visited once
+    std::vector<std::string_view> words;
+    for (const int document_id : pending_removal_) {
+        for (const auto& [word, _] : words_freqs_overall_.at(document_id)) {
+            words.push_back(word);
+        }
+    }
+    std::sort(words.begin(), words.end());
+    words.erase(std::unique(words.begin(), words.end()), words.end());
+
+    std::vector<std::pmr::map<int, double>*> postings(words.size());
+    std::transform(words.begin(), words.end(), postings.begin(),
+        [this](const std::string_view word) {
+            return &word_to_document_freqs_.at(word);
+        });
+
+    // every posting is a separate map, so terms are cleaned independently
+    ForEachIndex(policy, postings.size(),
+        [this, &postings](size_t index) {
+            std::pmr::map<int, double>* posting = postings[index];
+            for (auto it = posting->begin(); it != posting->end();) {
+                if (IsRemoved(it->first)) {
+                    it = posting->erase(it);
+                }
+                else {
+                    ++it;
+                }
+            }
+        });
+
+    for (const std::string_view word : words) {
+        DropEmptyPosting(word);
+    }
+
+    for (const int document_id : pending_removal_) {
+        words_freqs_overall_.erase(document_id);
+        documents_.erase(document_id);
+        removed_[document_id] = false;
+    }
+    pending_removal_.clear();
+}
+
+template <typename Policy>
+std::vector<int> SearchServer::FindDuplicatesImpl(Policy policy) const {
+    // ids_ holds live documents in increasing order, so the first of equal sets is the one kept
+    const std::vector<int> ids(ids_.begin(), ids_.end());
+    std::vector<const DocumentData*> documents(ids.size());
+    std::vector<TermSetFingerprint> fingerprints(ids.size());
+    ForEachIndex(policy, ids.size(),
+        [&](size_t index) {
+            documents[index] = &documents_.at(ids[index]);
+            fingerprints[index] = FingerprintTermSet(documents[index]->term_ids.data(), documents[index]->term_ids.size());
+        });
+
+    std::vector<int> duplicates;
+    std::unordered_map<TermSetFingerprint, size_t, TermSetFingerprintHasher> first_of(ids.size());
+    for (size_t index = 0; index < ids.size(); ++index) {
+        const auto [it, inserted] = first_of.emplace(fingerprints[index], index);
+        // a collision of different sets keeps both documents
+        if (!inserted && documents[it->second]->term_ids == documents[index]->term_ids) {
+            duplicates.push_back(ids[index]);
+        }
+    }
+    return duplicates;
+}
+
+template <typename Policy>
+std::vector<SearchServer::NearDuplicate> SearchServer::FindNearDuplicatesImpl(Policy policy, double threshold) const {
+    if (!(threshold > 0.0 && threshold <= 1.0)) {
+        throw std::invalid_argument("Similarity threshold must be in (0, 1]\n");
+    }
+    std::vector<int> ids;
+    std::vector<const std::pmr::vector<uint32_t>*> term_sets;
+    for (const int document_id : ids_) {
+        const std::pmr::vector<uint32_t>& term_ids = documents_.at(document_id).term_ids;
+        if (!term_ids.empty()) {
+            ids.push_back(document_id);
+            term_sets.push_back(&term_ids);
+        }
+    }
+
+    // positions is scratch of IntersectSorted
+    const auto jaccard = [&term_sets](uint32_t lhs_index, uint32_t rhs_index, std::vector<uint32_t>& positions) {
+        const std::pmr::vector<uint32_t>& lhs = *term_sets[lhs_index];
+        const std::pmr::vector<uint32_t>& rhs = *term_sets[rhs_index];
+        positions.resize(lhs.size());
+        const size_t common = IntersectSorted(lhs.data(), lhs.size(), rhs.data(), rhs.size(), positions.data());
+        return static_cast<double>(common) / static_cast<double>(lhs.size() + rhs.size() - common);
+    };
+
+    // one band at a time: memory stays linear in documents and candidates, whatever count of bands
+    const LshBands lsh = ChooseLshBands(threshold);
+    std::vector<std::pair<uint64_t, uint32_t>> band_keys(ids.size());        // HINT : < key, index in ids >
+    std::vector<std::pair<uint32_t, uint32_t>> candidates;
+    size_t unique_candidates = 0;
+    std::vector<std::pair<uint64_t, uint32_t>> members;                    // HINT : < order in band, index in ids >
+    std::vector<uint32_t> positions;
+    for (size_t band = 0; band < lsh.bands; ++band) {
+        ForEachIndex(policy, ids.size(),
+            [&](size_t index) {
+                band_keys[index] = { MinHashBandKey(term_sets[index]->data(), term_sets[index]->size(), band * lsh.rows, lsh.rows),
+                                     static_cast<uint32_t>(index) };
+            });
+        std::sort(band_keys.begin(), band_keys.end());
+        for (size_t begin = 0, end = 0; begin < band_keys.size(); begin = end) {
+            for (end = begin + 1; end < band_keys.size() && band_keys[end].first == band_keys[begin].first; ++end) {
+            }
+            if (end - begin <= NEAR_DUPLICATE_BUCKET_LIMIT) {
+                for (size_t first = begin; first < end; ++first) {
+                    for (size_t second = first + 1; second < end; ++second) {
+                        candidates.push_back({ band_keys[first].second, band_keys[second].second });
+                    }
+                }
+                continue;
+            }
+            // huge bucket is either a big cluster, paired all to all as most of its pairs are results anyway,
+            // or boilerplate documents, whose members get partners in an order shuffled by band: linear
+            // in its size, and pairs missed in one band are drawn in others
+            members.clear();
+            for (size_t index = begin; index < end; ++index) {
+                members.push_back({ MixBandOrder(band, band_keys[index].second), band_keys[index].second });
+            }
+            std::sort(members.begin(), members.end());
+            size_t similar = 0;
+            for (size_t index = 0; index < NEAR_DUPLICATE_BUCKET_LIMIT; ++index) {
+                similar += jaccard(members[index].second, members[index + 1].second, positions) >= threshold ? 1 : 0;
+            }
+            const size_t partner_count = similar * 2 >= NEAR_DUPLICATE_BUCKET_LIMIT ? members.size() / 2 : NEAR_DUPLICATE_PARTNER_COUNT;
+            for (size_t first = 0; first < members.size(); ++first) {
+                // HINT : steps up to half the size reach every pair, the middle one of an even size twice
+                for (size_t step = 1; step <= partner_count; ++step) {
+                    const uint32_t lhs = members[first].second;
+                    const uint32_t rhs = members[(first + step) % members.size()].second;
+                    candidates.push_back({ std::min(lhs, rhs), std::max(lhs, rhs) });
+                }
+            }
+        }
+        // repeats of a pair from earlier bands are dropped once they outnumber the unique ones
+        if (candidates.size() > 2 * unique_candidates) {
+            std::sort(candidates.begin(), candidates.end());
+            candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+            unique_candidates = candidates.size();
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    // exact jaccard of candidates, chunks reuse one intersection buffer
+    std::vector<double> similarities(candidates.size());
+    const size_t chunk_count = (candidates.size() + NEAR_DUPLICATE_CHUNK_SIZE - 1) / NEAR_DUPLICATE_CHUNK_SIZE;
+    ForEachIndex(policy, chunk_count,
+        [&](size_t chunk) {
+            std::vector<uint32_t> chunk_positions;
+            const size_t end = std::min(candidates.size(), (chunk + 1) * NEAR_DUPLICATE_CHUNK_SIZE);
+            for (size_t index = chunk * NEAR_DUPLICATE_CHUNK_SIZE; index < end; ++index) {
+                similarities[index] = jaccard(candidates[index].first, candidates[index].second, chunk_positions);
+            }
+        });
+
+    std::vector<NearDuplicate> near_duplicates;
+    for (size_t index = 0; index < candidates.size(); ++index) {
+        if (similarities[index] >= threshold) {
+            near_duplicates.push_back({ ids[candidates[index].first], ids[candidates[index].second], similarities[index] });
+        }
+    }
+    return near_duplicates;
+}
+
+template <typename Policy>
+SearchServer::MatchedDocuments SearchServer::MatchDocumentsImpl(Policy policy, const std::string_view raw_query, const std::vector<int>& document_ids) const {
+    for (const int document_id : document_ids) {
+        if (IsRemoved(document_id) || documents_.count(document_id) == 0) {
+            throw std::out_of_range("Invalid ID\n");
+        }
+    }
+
+    QueryArenaScope arena;
+    const Query query = ParseQuery(raw_query, true, arena.Resource());
+    ResolvedQuery terms(arena.Resource());
+    ResolveQuery(query, terms);
+
+    // every document fills its own slot of stride words, slots are packed afterwards
+    const size_t stride = terms.plus_terms.size();
+    MatchedDocuments matched;
+    matched.words.resize(document_ids.size() * stride);
+    matched.offsets.resize(document_ids.size() + 1);       // HINT : offsets[i + 1] holds count of i-th document before packing
+    matched.statuses.resize(document_ids.size());
+    std::pmr::vector<uint32_t> positions(document_ids.size() * stride, arena.Resource());
+
+    ForEachIndex(policy, document_ids.size(),
+        [&](size_t index) {
+            const int document_id = document_ids[index];
+            const DocumentData& document = documents_.at(document_id);
+            matched.statuses[index] = document.status;
+            matched.offsets[index + 1] = MatchTerms(terms, document, matched.words.data() + index * stride, positions.data() + index * stride);
+        });
+
+    size_t total = 0;
+    for (size_t index = 0; index < document_ids.size(); ++index) {
+        const size_t count = matched.offsets[index + 1];
+        std::copy_n(matched.words.begin() + index * stride, count, matched.words.begin() + total);
+        matched.offsets[index] = total;
+        total += count;
+    }
+    matched.offsets[document_ids.size()] = total;
+    matched.words.resize(total);
+    return matched;
+}
@@ -1,29 +1,333 @@
-#include "string_processing.h"
-
-std::vector<std::string_view> SplitIntoWords(const std::string_view text) {
-    std::vector<std::string_view> ret;
-    
-    size_t wordBegin = 0, symbolPos = 0, spacePos = 0;
-    do {
-        symbolPos   = text.find_first_not_of(' ', wordBegin);
-        spacePos    = text.find_first_of    (' ', symbolPos);
-
-        if (symbolPos == std::string_view::npos) {
-            // no more symbols
-            break;
-        }
-
-        // add word to vector
-        std::string_view word = text.substr(symbolPos, spacePos - symbolPos);
-        ret.push_back(word);
-
-        if (spacePos == std::string_view::npos) {
-            // no more spaces
-            break;
-        }
-        // go dig more words
-        wordBegin = spacePos;        
-    } while (1);
-
-    return ret;
-}
\ No newline at end of file
+#include "string_processing.h"
+
+#include <array>
+#include <cstring>
+
+#include "cpu_features.h"
+
+namespace {
+
+    const size_t BLOCK_SIZE = 64;
+
+    // HINT : bit i of spaces / specials -> block[i] is ' ' / is in [0, ' ')
+    using ClassifyBlockFunc = void (*)(const char* block, uint64_t& spaces, uint64_t& specials);
+
+    void ClassifyBlockScalar(const char* block, uint64_t& spaces, uint64_t& specials) {
+        spaces = 0;
+        specials = 0;
+        for (size_t i = 0; i < BLOCK_SIZE; ++i) {
+            const unsigned char c = static_cast<unsigned char>(block[i]);
+            spaces |= static_cast<uint64_t>(c == ' ') << i;
+            specials |= static_cast<uint64_t>(c < ' ') << i;
+        }
+    }
+
+#ifdef SEARCH_SERVER_X86
+
+    TARGET_SSE2 void ClassifyBlockSse2(const char* block, uint64_t& spaces, uint64_t& specials) {
+        const __m128i space = _mm_set1_epi8(' ');
+        const __m128i last_special = _mm_set1_epi8(' ' - 1);
+        spaces = 0;
+        specials = 0;
+        for (size_t i = 0; i < BLOCK_SIZE; i += 16) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+            // unsigned c <= 31  <->  min(c, 31) == c
+            const __m128i special = _mm_cmpeq_epi8(_mm_min_epu8(chunk, last_special), chunk);
+            spaces |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, space)))) << i;
+            specials |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(special))) << i;
+        }
+    }
+
+    TARGET_AVX2 void ClassifyBlockAvx2(const char* block, uint64_t& spaces, uint64_t& specials) {
+        const __m256i space = _mm256_set1_epi8(' ');
+        const __m256i last_special = _mm256_set1_epi8(' ' - 1);
+        spaces = 0;
+        specials = 0;
+        for (size_t i = 0; i < BLOCK_SIZE; i += 32) {
+            const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + i));
+            const __m256i special = _mm256_cmpeq_epi8(_mm256_min_epu8(chunk, last_special), chunk);
+            spaces |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, space)))) << i;
+            specials |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(special))) << i;
+        }
+    }
+
+#endif
+
+    // ISA is picked once, on first use
+    ClassifyBlockFunc SelectClassifyBlock() {
+#ifdef SEARCH_SERVER_X86
+        if (CpuHasAvx2()) {
+            return ClassifyBlockAvx2;
+        }
+        if (CpuHasSse2()) {
+            return ClassifyBlockSse2;
+        }
+#endif
+        return ClassifyBlockScalar;
+    }
+
+    // tail shorter than a block is padded with spaces
+    void ClassifyBlock(const char* data, size_t size, uint64_t& spaces, uint64_t& specials) {
+        static const ClassifyBlockFunc classify_block = SelectClassifyBlock();
+        if (size >= BLOCK_SIZE) {
+            classify_block(data, spaces, specials);
+            return;
+        }
+        char block[BLOCK_SIZE];
+        std::memset(block, ' ', BLOCK_SIZE);
+        std::memcpy(block, data, size);
+        classify_block(block, spaces, specials);
+    }
+
+    int CountTrailingZeros(uint64_t bits) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward64(&index, bits);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctzll(bits);
+#endif
+    }
+
+    // HINT : folded code point of every code point below 0x800, i.e. of every one- and two-byte symbol
+    const std::array<uint16_t, 0x800>& CaseFoldTable() {
+        static const std::array<uint16_t, 0x800> table = [] {
+            std::array<uint16_t, 0x800> fold{};
+            for (uint16_t c = 0; c < fold.size(); ++c) {
+                fold[c] = c;
+            }
+            auto fold_range = [&](uint16_t first, uint16_t last, uint16_t shift) {
+                for (uint16_t c = first; c <= last; ++c) {
+                    fold[c] = c + shift;
+                }
+            };
+            // upper case letter followed by its lower case one
+            auto fold_pairs = [&](uint16_t first, uint16_t last) {
+                for (uint16_t c = first; c < last; c += 2) {
+                    fold[c] = c + 1;
+                }
+            };
+            fold_range('A', 'Z', 0x20);
+            fold_range(0xC0, 0xDE, 0x20);               // Latin-1
+            fold[0xD7] = 0xD7;                          // multiplication sign
+            fold_pairs(0x100, 0x12F);                   // Latin Extended-A, U+0130 folds to ASCII and is kept
+            fold_pairs(0x132, 0x137);
+            fold_pairs(0x139, 0x148);
+            fold_pairs(0x14A, 0x177);
+            fold_pairs(0x179, 0x17E);
+            fold[0x178] = 0xFF;
+            fold_range(0x391, 0x3AB, 0x20);             // Greek
+            fold[0x3A2] = 0x3A2;
+            fold_range(0x400, 0x40F, 0x50);             // Cyrillic
+            fold_range(0x410, 0x42F, 0x20);
+            fold_pairs(0x460, 0x481);
+            fold_pairs(0x48A, 0x4BF);
+            fold_pairs(0x4C1, 0x4CE);
+            fold_pairs(0x4D0, 0x4FF);
+            return fold;
+        }();
+        return table;
+    }
+
+    // first byte at or after pos that is an upper case ASCII letter or starts a non-ASCII symbol
+    size_t SkipPlainAscii(const char* data, size_t size, size_t pos) {
+#if defined(SEARCH_SERVER_X86) && (defined(__SSE2__) || defined(_M_X64))
+        const __m128i first_upper = _mm_set1_epi8('A');
+        const __m128i upper_span = _mm_set1_epi8('Z' - 'A');
+        for (; pos + 16 <= size; pos += 16) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+            const __m128i offset = _mm_sub_epi8(chunk, first_upper);
+            const __m128i upper = _mm_cmpeq_epi8(_mm_min_epu8(offset, upper_span), offset);
+            // high bit of chunk marks non-ASCII bytes
+            const int mask = _mm_movemask_epi8(_mm_or_si128(upper, chunk));
+            if (mask != 0) {
+                return pos + CountTrailingZeros(static_cast<uint64_t>(mask));
+            }
+        }
+#endif
+        for (; pos < size; ++pos) {
+            const unsigned char c = static_cast<unsigned char>(data[pos]);
+            if (c >= 0x80 || static_cast<unsigned char>(c - 'A') <= 'Z' - 'A') {
+                return pos;
+            }
+        }
+        return size;
+    }
+
+    // HINT : writes folded symbol at s into folded, returns symbol width (1 or 2 bytes)
+    size_t FoldSymbol(const char* s, size_t size, char folded[2]) {
+        const unsigned char lead = static_cast<unsigned char>(s[0]);
+        if (lead < 0x80) {
+            folded[0] = static_cast<char>(CaseFoldTable()[lead]);
+            return 1;
+        }
+        const unsigned char next = size > 1 ? static_cast<unsigned char>(s[1]) : 0;
+        if (lead < 0xC2 || lead > 0xDF || (next & 0xC0) != 0x80) {
+            folded[0] = s[0];           // longer or broken sequence
+            return 1;
+        }
+        const uint16_t code = CaseFoldTable()[((lead & 0x1F) << 6) | (next & 0x3F)];
+        folded[0] = static_cast<char>(0xC0 | (code >> 6));
+        folded[1] = static_cast<char>(0x80 | (code & 0x3F));
+        return 2;
+    }
+
+    template <typename Buffer>
+    std::string_view FoldCaseInto(const std::string_view text, Buffer& buffer) {
+        // most words are already lower case, copy only when a symbol really changes
+        size_t pos = 0;
+        while (true) {
+            pos = SkipPlainAscii(text.data(), text.size(), pos);
+            if (pos == text.size()) {
+                return text;
+            }
+            char folded[2];
+            const size_t width = FoldSymbol(text.data() + pos, text.size() - pos, folded);
+            if (std::memcmp(folded, text.data() + pos, width) != 0) {
+                break;
+            }
+            pos += width;
+        }
+
+        buffer.assign(text.begin(), text.end());
+        while ((pos = SkipPlainAscii(buffer.data(), buffer.size(), pos)) < buffer.size()) {
+            pos += FoldSymbol(buffer.data() + pos, buffer.size() - pos, buffer.data() + pos);
+        }
+        return std::string_view(buffer.data(), buffer.size());
+    }
+
+    bool IsAsciiPunctuation(unsigned char c) {
+        return (c >= '!' && c <= '/') || (c >= ':' && c <= '@') || (c >= '[' && c <= '`') || (c >= '{' && c <= '~');
+    }
+
+    // HINT : U+00A1 ¡, U+00AB «, U+00B7 ·, U+00BB », U+00BF ¿ and U+2010..U+205E (dashes, quotes, ellipsis)
+    bool IsUtf8Punctuation(const std::string_view symbol) {
+        const auto byte = [&](size_t i) { return static_cast<unsigned char>(symbol[i]); };
+        if (symbol.size() == 2) {
+            return byte(0) == 0xC2 && (byte(1) == 0xA1 || byte(1) == 0xAB || byte(1) == 0xB7 || byte(1) == 0xBB || byte(1) == 0xBF);
+        }
+        return symbol.size() == 3 && byte(0) == 0xE2
+            && ((byte(1) == 0x80 && byte(2) >= 0x90) || (byte(1) == 0x81 && byte(2) <= 0x9E));
+    }
+
+}
+
+/************************************ WORD SCANNER ************************************/
+
+WordScanner::WordScanner(const std::string_view text)
+    : text_(text) {
+}
+
+bool WordScanner::LoadBlock() {
+    if (next_block_pos_ >= text_.size() || !valid_) {
+        return false;
+    }
+    block_pos_ = next_block_pos_;
+    next_block_pos_ += BLOCK_SIZE;
+
+    uint64_t spaces, specials;
+    ClassifyBlock(text_.data() + block_pos_, text_.size() - block_pos_, spaces, specials);
+    if (specials != 0) {
+        valid_ = false;
+        return false;
+    }
+
+    // word symbol after space starts a word, space after word symbol ends it
+    const uint64_t word = ~spaces;
+    const uint64_t previous = (word << 1) | in_word_;
+    starts_ = word & ~previous;
+    ends_ = ~word & previous;
+    in_word_ = word >> 63;
+    return true;
+}
+
+bool WordScanner::Next(std::string_view& word) {
+    while (true) {
+        if (word_start_ == std::string_view::npos) {
+            if (starts_ == 0) {
+                if (!LoadBlock()) {
+                    return false;
+                }
+                continue;
+            }
+            word_start_ = block_pos_ + CountTrailingZeros(starts_);
+            starts_ &= starts_ - 1;
+        }
+
+        if (ends_ != 0) {
+            const size_t word_end = block_pos_ + CountTrailingZeros(ends_);
+            ends_ &= ends_ - 1;
+            word = text_.substr(word_start_, word_end - word_start_);
+            word_start_ = std::string_view::npos;
+            return true;
+        }
+        if (!LoadBlock()) {
+            // text ends right after a word that fills the last block
+            if (!valid_ || word_start_ >= text_.size()) {
+                return false;
+            }
+            word = text_.substr(word_start_);
+            word_start_ = std::string_view::npos;
+            return true;
+        }
+    }
+}
+
+/************************************ FUNCTIONS ************************************/
+
+std::vector<std::string_view> SplitIntoWords(const std::string_view text) {
+    std::vector<std::string_view> ret;
+    WordScanner scanner(text);
+    for (std::string_view word; scanner.Next(word);) {
+        ret.push_back(word);
+    }
+    return ret;
+}
+
+std::string_view FoldCase(const std::string_view text, std::vector<char>& buffer) {
+    return FoldCaseInto(text, buffer);
+}
+
+std::string_view FoldCase(const std::string_view text, std::pmr::vector<char>& buffer) {
+    return FoldCaseInto(text, buffer);
+}
+
+std::string_view TrimPunctuation(std::string_view word) {
+    while (!word.empty()) {
+        if (IsAsciiPunctuation(static_cast<unsigned char>(word.front()))) {
+            word.remove_prefix(1);
+        }
+        else if (IsUtf8Punctuation(word.substr(0, 2)) || IsUtf8Punctuation(word.substr(0, 3))) {
+            word.remove_prefix(static_cast<unsigned char>(word.front()) == 0xC2 ? 2 : 3);
+        }
+        else {
+            break;
+        }
+    }
+    while (!word.empty()) {
+        if (IsAsciiPunctuation(static_cast<unsigned char>(word.back()))) {
+            word.remove_suffix(1);
+        }
+        else if (word.size() >= 2 && IsUtf8Punctuation(word.substr(word.size() - 2))) {
+            word.remove_suffix(2);
+        }
+        else if (word.size() >= 3 && IsUtf8Punctuation(word.substr(word.size() - 3))) {
+            word.remove_suffix(3);
+        }
+        else {
+            break;
+        }
+    }
+    return word;
+}
+
+bool HasSpecialSymbols(const std::string_view text) {
+    for (size_t pos = 0; pos < text.size(); pos += BLOCK_SIZE) {
+        uint64_t spaces, specials;
+        ClassifyBlock(text.data() + pos, text.size() - pos, spaces, specials);
+        if (specials != 0) {
+            return true;
+        }
+    }
+    return false;
+}
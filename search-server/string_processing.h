@@ -1,6 +1,198 @@
-#pragma once
-
-#include <string>
-#include <vector>
-
-std::vector<std::string_view> SplitIntoWords(const std::string_view text);
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if __cplusplus >= 202002L
+#include <ranges>
+#endif
+
+// Pulls words out of text in one pass. Text is classified by 64-byte blocks
+// (AVX2 or SSE2 when CPU has it, scalar otherwise): spaces give word boundaries,
+// symbols in [0, ' ') make text invalid and stop the scan
+class WordScanner {
+public:
+    explicit WordScanner(const std::string_view text);
+
+    // false when text is over or special symbol is met
+    bool Next(std::string_view& word);
+
+    // no special symbol met so far
+    bool Valid() const {
+        return valid_;
+    }
+
+private:
+    bool LoadBlock();
+
+    std::string_view text_;
+    size_t block_pos_ = 0;          // start of current block
+    size_t next_block_pos_ = 0;
+    uint64_t starts_ = 0;           // HINT : bit i -> word starts at block_pos_ + i
+    uint64_t ends_ = 0;             // HINT : bit i -> word ends before block_pos_ + i
+    uint64_t in_word_ = 0;          // last byte of previous block is a word symbol
+    size_t word_start_ = std::string_view::npos;
+    bool valid_ = true;
+};
+
+// Lazy range of words over text, nothing is allocated. Works in range-for, with STL
+// algorithms and as a C++20 forward_range. Incrementing past a special symbol
+// throws std::invalid_argument with given message
+class WordRange {
+public:
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view*;
+        using reference = const std::string_view&;
+
+        Iterator() = default;       // end of any range
+
+        Iterator(const std::string_view text, const char* error)
+            : scanner_(text)
+            , error_(error)
+            , at_end_(false) {
+            ++*this;
+        }
+
+        reference operator*() const {
+            return word_;
+        }
+
+        pointer operator->() const {
+            return &word_;
+        }
+
+        Iterator& operator++() {
+            if (!scanner_.Next(word_)) {
+                if (!scanner_.Valid()) {
+                    throw std::invalid_argument(error_);
+                }
+                word_ = std::string_view();
+                at_end_ = true;
+            }
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator ret = *this;
+            ++*this;
+            return ret;
+        }
+
+        bool operator==(const Iterator& other) const {
+            return at_end_ == other.at_end_ && word_.data() == other.word_.data();
+        }
+
+        bool operator!=(const Iterator& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        WordScanner scanner_{ std::string_view() };
+        const char* error_ = nullptr;
+        std::string_view word_;
+        bool at_end_ = true;
+    };
+
+    explicit WordRange(const std::string_view text, const char* error = "Special symbol in text")
+        : text_(text)
+        , error_(error) {
+    }
+
+    Iterator begin() const {
+        return Iterator(text_, error_);
+    }
+
+    Iterator end() const {
+        return Iterator();
+    }
+
+private:
+    std::string_view text_;
+    const char* error_;
+};
+
+#if __cplusplus >= 202002L
+// iterators point into text, not into the range
+template <>
+inline constexpr bool std::ranges::enable_borrowed_range<WordRange> = true;
+static_assert(std::ranges::forward_range<WordRange>);
+#endif
+
+inline WordRange SplitIntoWordsLazy(const std::string_view text, const char* error = "Special symbol in text") {
+    return WordRange(text, error);
+}
+
+// words of valid text, stops at the first special symbol
+std::vector<std::string_view> SplitIntoWords(const std::string_view text);
+
+// true if text has a symbol in [0, ' ')
+bool HasSpecialSymbols(const std::string_view text);
+
+// Lower case copy of text in buffer, or text itself when nothing changes.
+// ASCII is skipped by 16-byte blocks, two-byte UTF-8 (Latin, Greek, Cyrillic) folds
+// by table, other symbols and broken UTF-8 stay as they are. Length never changes
+std::string_view FoldCase(const std::string_view text, std::vector<char>& buffer);
+std::string_view FoldCase(const std::string_view text, std::pmr::vector<char>& buffer);
+
+// word without ASCII and common UTF-8 punctuation (quotes, dashes, ellipsis) at its edges,
+// may become empty
+std::string_view TrimPunctuation(std::string_view word);
+
+// HINT : plus and minus words of a query, views into folded_text or into the parsed text
+struct ParsedQuery {
+    explicit ParsedQuery(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : plus_words(resource)
+        , minus_words(resource)
+        , folded_text(resource) {
+    }
+
+    std::pmr::vector<std::string_view> plus_words;
+    std::pmr::vector<std::string_view> minus_words;
+    std::pmr::vector<char> folded_text;     // HINT : words may point here, moves keep it in place
+};
+
+// Query syntax of every server: case folded words, "-word" excludes word, punctuation is trimmed
+// after the minus, so "-rat," excludes "rat". Words is_stop_word accepts are dropped, sort makes both
+// lists sorted and unique. Throws invalid_argument on special symbols, a lone or a double minus
+template <typename StopWordPredicate>
+ParsedQuery ParseQueryText(const std::string_view text, StopWordPredicate is_stop_word, bool sort = true,
+                           std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+    ParsedQuery query(resource);
+    const std::string_view folded = FoldCase(text, query.folded_text);
+    for (std::string_view word : SplitIntoWordsLazy(folded, "Special symbol in ParseQuery()")) {
+        bool is_minus = false;
+        if (word[0] == '-') {
+            is_minus = true;
+            word = word.substr(1);
+            if (word.empty()) {
+                throw std::invalid_argument("No word after minus in ParseQuery()");
+            }
+            if (word[0] == '-') {
+                throw std::invalid_argument("Double minus in ParseQuery()");
+            }
+        }
+        word = TrimPunctuation(word);
+        if (!word.empty() && !is_stop_word(word)) {
+            (is_minus ? query.minus_words : query.plus_words).push_back(word);
+        }
+    }
+    // queries have a handful of words, parallel sort costs more than it saves
+    if (sort) {
+        for (std::pmr::vector<std::string_view>* words : { &query.plus_words, &query.minus_words }) {
+            std::sort(words->begin(), words->end());
+            words->erase(std::unique(words->begin(), words->end()), words->end());
+        }
+    }
+    return query;
+}
@@ -0,0 +1,71 @@
+#include "term_fingerprint.h"
+
+#include <cmath>
+#include <limits>
+
+namespace {
+
+    // HINT : two independent 64-bit chains, every id goes through a full avalanche in both
+    const uint64_t LOW_SEED = 0x9E3779B97F4A7C15ull;
+    const uint64_t HIGH_SEED = 0xC2B2AE3D27D4EB4Full;
+    const uint64_t LOW_MULTIPLIER = 0xBF58476D1CE4E5B9ull;
+    const uint64_t HIGH_MULTIPLIER = 0x94D049BB133111EBull;
+
+    uint64_t Mix(uint64_t x, uint64_t multiplier) {
+        x ^= x >> 31;
+        x *= multiplier;
+        x ^= x >> 29;
+        x *= 0xD6E8FEB86659FD93ull;
+        x ^= x >> 32;
+        return x;
+    }
+
+}
+
+uint64_t MinHashBandKey(const uint32_t* ids, size_t count, size_t first_function, size_t function_count) {
+    // HINT : function f(x) = a_f * Mix(x) + b_f with odd a_f, a permutation of 64-bit values
+    uint64_t multipliers[MINHASH_SIGNATURE_SIZE];
+    uint64_t offsets[MINHASH_SIGNATURE_SIZE];
+    uint64_t min_values[MINHASH_SIGNATURE_SIZE];
+    for (size_t f = 0; f < function_count; ++f) {
+        multipliers[f] = Mix(LOW_SEED + first_function + f, LOW_MULTIPLIER) | 1;
+        offsets[f] = Mix(HIGH_SEED + first_function + f, HIGH_MULTIPLIER);
+        min_values[f] = std::numeric_limits<uint64_t>::max();
+    }
+    // every id is hashed once, functions only rescale the hash
+    for (size_t i = 0; i < count; ++i) {
+        const uint64_t hash = Mix(ids[i] + HIGH_SEED, HIGH_MULTIPLIER);
+        for (size_t f = 0; f < function_count; ++f) {
+            const uint64_t value = multipliers[f] * hash + offsets[f];
+            min_values[f] = value < min_values[f] ? value : min_values[f];
+        }
+    }
+    uint64_t key = LOW_SEED ^ first_function;
+    for (size_t f = 0; f < function_count; ++f) {
+        key = Mix(key ^ min_values[f], LOW_MULTIPLIER);
+    }
+    return key;
+}
+
+LshBands ChooseLshBands(double threshold) {
+    LshBands chosen{ MINHASH_SIGNATURE_SIZE, 1 };
+    for (size_t rows = 2; rows <= MINHASH_SIGNATURE_SIZE / 4; ++rows) {
+        const size_t bands = MINHASH_SIGNATURE_SIZE / rows;
+        // probability that at least one band of the pair is equal
+        const double candidate = 1.0 - std::pow(1.0 - std::pow(threshold, static_cast<double>(rows)), static_cast<double>(bands));
+        if (candidate >= 0.99) {
+            chosen = { bands, rows };
+        }
+    }
+    return chosen;
+}
+
+TermSetFingerprint FingerprintTermSet(const uint32_t* ids, size_t count) {
+    uint64_t low = LOW_SEED ^ count;
+    uint64_t high = HIGH_SEED + count;
+    for (size_t i = 0; i < count; ++i) {
+        low = Mix(low ^ (ids[i] + LOW_SEED), LOW_MULTIPLIER);
+        high = Mix(high + (ids[i] ^ HIGH_SEED), HIGH_MULTIPLIER);
+    }
+    return { low, high };
+}
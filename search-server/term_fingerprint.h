@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// 128-bit hash of a set of term ids, equal sets give equal fingerprints
+struct TermSetFingerprint {
+    uint64_t low = 0;
+    uint64_t high = 0;
+
+    bool operator==(const TermSetFingerprint& other) const {
+        return low == other.low && high == other.high;
+    }
+
+    bool operator!=(const TermSetFingerprint& other) const {
+        return !(*this == other);
+    }
+};
+
+struct TermSetFingerprintHasher {
+    size_t operator()(const TermSetFingerprint& fingerprint) const {
+        return static_cast<size_t>(fingerprint.low);       // already well mixed
+    }
+};
+
+// ids must be sorted, so the same set always gives the same fingerprint
+TermSetFingerprint FingerprintTermSet(const uint32_t* ids, size_t count);
+
+// HINT : hash functions available to MinHash signatures
+const size_t MINHASH_SIGNATURE_SIZE = 128;
+
+// MinHash values of functions [first_function, first_function + function_count) of a non-empty
+// set of term ids folded into one key. Two sets get equal keys with probability about
+// jaccard ^ function_count
+uint64_t MinHashBandKey(const uint32_t* ids, size_t count, size_t first_function, size_t function_count);
+
+// HINT : LSH banding, bands * rows <= MINHASH_SIGNATURE_SIZE
+struct LshBands {
+    size_t bands = 0;
+    size_t rows = 0;
+};
+
+// longest rows that still make a pair of given jaccard similarity a candidate in 99% of cases,
+// longer rows let fewer dissimilar pairs through
+LshBands ChooseLshBands(double threshold);
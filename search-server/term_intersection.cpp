@@ -0,0 +1,167 @@
+#include "term_intersection.h"
+
+#include "cpu_features.h"
+
+namespace {
+
+    // HINT : larger array this many times longer -> galloping beats the linear scan
+    const size_t GALLOP_RATIO = 32;
+
+    using IntersectFunc = size_t (*)(const uint32_t* lhs, size_t lhs_size, const uint32_t* rhs, size_t rhs_size, uint32_t* out);
+
+    // first position in [begin, size) with data[pos] >= value, steps double from begin
+    size_t Gallop(const uint32_t* data, size_t begin, size_t size, uint32_t value) {
+        size_t step = 1;
+        size_t low = begin;
+        size_t high = begin;
+        while (high < size && data[high] < value) {
+            low = high + 1;
+            high += step;
+            step *= 2;
+        }
+        if (high > size) {
+            high = size;
+        }
+        while (low < high) {
+            const size_t middle = low + (high - low) / 2;
+            if (data[middle] < value) {
+                low = middle + 1;
+            }
+            else {
+                high = middle;
+            }
+        }
+        return low;
+    }
+
+    size_t IntersectGallopLhs(const uint32_t* lhs, size_t lhs_size, const uint32_t* rhs, size_t rhs_size, uint32_t* out) {
+        size_t count = 0;
+        size_t j = 0;
+        for (size_t i = 0; i < lhs_size && j < rhs_size; ++i) {
+            j = Gallop(rhs, j, rhs_size, lhs[i]);
+            if (j < rhs_size && rhs[j] == lhs[i]) {
+                out[count++] = static_cast<uint32_t>(i);
+            }
+        }
+        return count;
+    }
+
+    size_t IntersectGallopRhs(const uint32_t* lhs, size_t lhs_size, const uint32_t* rhs, size_t rhs_size, uint32_t* out) {
+        size_t count = 0;
+        size_t i = 0;
+        for (size_t j = 0; j < rhs_size && i < lhs_size; ++j) {
+            i = Gallop(lhs, i, lhs_size, rhs[j]);
+            if (i < lhs_size && lhs[i] == rhs[j]) {
+                out[count++] = static_cast<uint32_t>(i);
+            }
+        }
+        return count;
+    }
+
+    // merge of what is left after block kernels
+    size_t IntersectTail(const uint32_t* lhs, size_t i, size_t lhs_size, const uint32_t* rhs, size_t j, size_t rhs_size, uint32_t* out, size_t count) {
+        while (i < lhs_size && j < rhs_size) {
+            if (lhs[i] < rhs[j]) {
+                ++i;
+            }
+            else if (rhs[j] < lhs[i]) {
+                ++j;
+            }
+            else {
+                out[count++] = static_cast<uint32_t>(i);
+                ++i;
+                ++j;
+            }
+        }
+        return count;
+    }
+
+    size_t IntersectScalar(const uint32_t* lhs, size_t lhs_size, const uint32_t* rhs, size_t rhs_size, uint32_t* out) {
+        return IntersectTail(lhs, 0, lhs_size, rhs, 0, rhs_size, out, 0);
+    }
+
+#ifdef SEARCH_SERVER_X86
+
+    // Block of rhs stays loaded while lhs values up to its last element are compared
+    // against all its lanes: lhs[i] > every earlier block, so a match can only be here
+    TARGET_SSE2 size_t IntersectSse2(const uint32_t* lhs, size_t lhs_size, const uint32_t* rhs, size_t rhs_size, uint32_t* out) {
+        size_t count = 0;
+        size_t i = 0;
+        size_t j = 0;
+        for (; i < lhs_size && j + 4 <= rhs_size; j += 4) {
+            const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + j));
+            const uint32_t block_last = rhs[j + 3];
+            for (; i < lhs_size && lhs[i] <= block_last; ++i) {
+                const __m128i equal = _mm_cmpeq_epi32(block, _mm_set1_epi32(static_cast<int>(lhs[i])));
+                if (_mm_movemask_epi8(equal) != 0) {
+                    out[count++] = static_cast<uint32_t>(i);
+                }
+            }
+        }
+        return IntersectTail(lhs, i, lhs_size, rhs, j, rhs_size, out, count);
+    }
+
+    TARGET_AVX2 size_t IntersectAvx2(const uint32_t* lhs, size_t lhs_size, const uint32_t* rhs, size_t rhs_size, uint32_t* out) {
+        size_t count = 0;
+        size_t i = 0;
+        size_t j = 0;
+        for (; i < lhs_size && j + 8 <= rhs_size; j += 8) {
+            const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs + j));
+            const uint32_t block_last = rhs[j + 7];
+            for (; i < lhs_size && lhs[i] <= block_last; ++i) {
+                const __m256i equal = _mm256_cmpeq_epi32(block, _mm256_set1_epi32(static_cast<int>(lhs[i])));
+                if (_mm256_movemask_epi8(equal) != 0) {
+                    out[count++] = static_cast<uint32_t>(i);
+                }
+            }
+        }
+        return IntersectTail(lhs, i, lhs_size, rhs, j, rhs_size, out, count);
+    }
+
+#endif
+
+    // ISA is picked once, on first use
+    IntersectFunc SelectIntersectBlocks() {
+#ifdef SEARCH_SERVER_X86
+        if (CpuHasAvx2()) {
+            return IntersectAvx2;
+        }
+        if (CpuHasSse2()) {
+            return IntersectSse2;
+        }
+#endif
+        return IntersectScalar;
+    }
+
+}
+
+bool IntersectsSorted(const uint32_t* lhs, size_t lhs_size, const uint32_t* rhs, size_t rhs_size) {
+    if (lhs_size == 0 || rhs_size == 0 || lhs[lhs_size - 1] < rhs[0] || rhs[rhs_size - 1] < lhs[0]) {
+        return false;
+    }
+    if (rhs_size < lhs_size) {
+        return IntersectsSorted(rhs, rhs_size, lhs, lhs_size);
+    }
+    size_t j = 0;
+    for (size_t i = 0; i < lhs_size && j < rhs_size; ++i) {
+        j = Gallop(rhs, j, rhs_size, lhs[i]);
+        if (j < rhs_size && rhs[j] == lhs[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t IntersectSorted(const uint32_t* lhs, size_t lhs_size, const uint32_t* rhs, size_t rhs_size, uint32_t* out) {
+    if (lhs_size == 0 || rhs_size == 0 || lhs[lhs_size - 1] < rhs[0] || rhs[rhs_size - 1] < lhs[0]) {
+        return 0;
+    }
+    if (lhs_size * GALLOP_RATIO < rhs_size) {
+        return IntersectGallopLhs(lhs, lhs_size, rhs, rhs_size, out);
+    }
+    if (rhs_size * GALLOP_RATIO < lhs_size) {
+        return IntersectGallopRhs(lhs, lhs_size, rhs, rhs_size, out);
+    }
+    static const IntersectFunc intersect_blocks = SelectIntersectBlocks();
+    return intersect_blocks(lhs, lhs_size, rhs, rhs_size, out);
+}
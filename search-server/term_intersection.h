@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Intersection of two strictly increasing arrays of term ids.
+// Writes positions in lhs of values also present in rhs to out (room for lhs_size),
+// in increasing order, and returns their count.
+// Sizes far apart -> galloping search of the smaller array's values in the larger one,
+// similar sizes -> each lhs value is compared against a block of rhs at once
+// (AVX2 or SSE2 when CPU has it, scalar merge otherwise)
+size_t IntersectSorted(const uint32_t* lhs, size_t lhs_size, const uint32_t* rhs, size_t rhs_size, uint32_t* out);
+
+// true if two strictly increasing arrays share a value, nothing is written.
+// Values of the smaller array are searched in the larger one by galloping
+bool IntersectsSorted(const uint32_t* lhs, size_t lhs_size, const uint32_t* rhs, size_t rhs_size);
@@ -1,614 +1,1925 @@
-﻿#pragma once
-
-#include <string>
-#include <iostream>
-#include <vector>
-#include <tuple>
-#include <set>
-#include <cassert>
-
-#include "search_server.h"
-//#include "process_queries.h"
-
-namespace MyUnitTests {
-
-    using std::string;
-    using std::cerr;
-
-    using namespace std;            // need it here to avoid massive amount of ""s errors
-
-    template <typename T, typename U>
-    void AssertEqualImpl(const T& t, const U& u, const string& t_str, const string& u_str, const string& file, const string& func, unsigned line, const string& hint) {
-        if (t != u) {
-            cerr << boolalpha;
-            cerr << file << "(" << line << "): " << func << ": ";
-            cerr << "ASSERT_EQUAL(" << t_str << ", " << u_str << ") failed: ";
-            cerr << t << " != " << u << ".";
-            if (!hint.empty()) {
-                cerr << " Hint: " << hint;
-            }
-            cerr << std::endl;
-            abort();
-        }
-    }
-
-    void AssertImpl(bool value, const string& expr_str, const string& file, const string& func, unsigned line,
-        const string& hint) {
-        if (!value) {
-            cerr << file << "(" << line << "): " << func << ": ";
-            cerr << "ASSERT(" << expr_str << ") failed.";
-            if (!hint.empty()) {
-                cerr << " Hint: " << hint;
-            }
-            cerr << std::endl;
-            abort();
-        }
-    }
-
-    template <typename T>
-    void RunTestImpl(const T& func, const string& func_name) {
-        func();
-        cerr << func_name << " OK\n";
-    }
-
-#define ASSERT(expr) AssertImpl(!!(expr), #expr, __FILE__, __FUNCTION__, __LINE__, "")
-
-#define ASSERT_HINT(expr, hint) AssertImpl(!!(expr), #expr, __FILE__, __FUNCTION__, __LINE__, (hint))
-
-#define ASSERT_EQUAL(a, b) AssertEqualImpl((a), (b), #a, #b, __FILE__, __FUNCTION__, __LINE__, "")
-
-#define ASSERT_EQUAL_HINT(a, b, hint) AssertEqualImpl((a), (b), #a, #b, __FILE__, __FUNCTION__, __LINE__, (hint))
-
-#define RUN_TEST(func) RunTestImpl((func), #func)
-
-
-    // -------- Начало модульных тестов поисковой системы ----------
-
-    // Тест проверяет, что поисковая система исключает стоп-слова при добавлении документов
-
-#if 1
-    void TestExcludeStopWordsFromAddedDocumentContent() {
-        const int doc_id = 42;
-        const string content = "cat in the city";
-        const std::vector<int> ratings = { 1, 2, 3 };
-        {
-            SearchServer server("in the"sv);
-            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
-            std::vector<Document> res = server.FindTopDocuments("cat"sv);
-            ASSERT_EQUAL(res.size(), 1u);
-            const Document& doc0 = res[0];
-            ASSERT_EQUAL(doc0.id, doc_id);
-        }
-        {
-            SearchServer server("in the"sv);
-            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
-            std::vector<Document> res = server.FindTopDocuments("in"sv);
-            ASSERT_HINT(res.empty(), "top words must be excluded from documents");
-        }
-    }
-
-#endif
-
-    void TestSplitIntoWords() {
-        {
-            std::vector<std::string_view> exp = { "aaa" , "bbb" };
-            std::vector<std::string_view> res = SplitIntoWords("   aaa    bbb   ");
-            //ASSERT_EQUAL_HINT(exp, res, "SplitIntoWords not works");
-        }
-        {
-            std::vector<std::string_view> exp = { "aaa" , "bbb" };
-            std::vector<std::string_view> res = SplitIntoWords("aaa    bbb   ");
-            //ASSERT_EQUAL_HINT(exp, res, "SplitIntoWords not works");
-        }
-        {
-            std::vector<std::string_view> exp = { "aaa" , "bbb" };
-            std::vector<std::string_view> res = SplitIntoWords("   aaa    bbb");
-            //ASSERT_EQUAL_HINT(exp, res, "SplitIntoWords not works");
-        }
-        {
-            std::vector<std::string_view> exp = { "aaa" , "bbb" };
-            std::vector<std::string_view> res = SplitIntoWords("aaa    bbb");
-            //ASSERT_EQUAL_HINT(exp, res, "SplitIntoWords not works");
-        }
-        {
-            std::vector<std::string_view> exp;
-            std::vector<std::string_view> res = SplitIntoWords("");
-            //ASSERT_EQUAL_HINT(exp, res, "SplitIntoWords not works");
-        }
-        {
-            std::vector<std::string_view> exp;
-            std::vector<std::string_view> res = SplitIntoWords("     ");
-            //ASSERT_EQUAL_HINT(exp, res, "SplitIntoWords not works");
-        }
-        {
-            std::vector<std::string_view> exp = { "aaa" , "bbb", "cc", "dddd"};
-            std::vector<std::string_view> res = SplitIntoWords("   aaa    bbb     cc   dddd  ");
-            //ASSERT_EQUAL_HINT(exp, res, "SplitIntoWords not works");
-        }
-    }
-#if 1
-
-    void TestExcludeDocumentsByMinusWords() {
-        const int doc_id = 12;
-        const string content = "cat in the city";
-        const std::vector<int> ratings = { 1, 2, 3 };
-        {
-            SearchServer server(std::string_view{ "in the" });
-            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
-            std::vector<Document> res = server.FindTopDocuments("cat -city"sv);
-            ASSERT_EQUAL(res.size(), 0u);
-        }
-        {
-            SearchServer server(std::string_view{ "in the" });
-            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
-            std::vector<Document> res = server.FindTopDocuments("-city"sv);
-            ASSERT_EQUAL(res.size(), 0u);
-        }
-        {
-            SearchServer server(std::string_view{ "in the" });
-            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
-            std::vector<Document> res = server.FindTopDocuments("-city -city"sv);
-            ASSERT_EQUAL(res.size(), 0u);
-        }
-        {
-            SearchServer server(std::string_view{ "in the" });
-            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
-            std::vector<Document> res = server.FindTopDocuments("city -city"sv);
-            ASSERT_EQUAL(res.size(), 0u);
-        }
-        {
-            SearchServer server(std::string_view{ "in the" });
-            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
-            std::vector<Document> res = server.FindTopDocuments("city -a"sv);
-            ASSERT_EQUAL(res.size(), 1u);
-        }
-    }
-
-#endif
-#if 1
-
-    void TestMatchingDocumentsByQuerry() {
-        const int doc_id = 12;
-        const string content = "cat in the city";
-        const std::vector<int> ratings = { 1, 2, 3 };
-        {
-            SearchServer server(std::string_view{ "in the" });
-            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
-            const string query_test = "cat";
-            std::tuple<std::vector<string_view>, DocumentStatus> expected = server.MatchDocument(query_test, 12);
-
-            auto& [a, b] = expected;
-
-            //std::vector<string> a;
-            //DocumentStatus b;
-            //tie(a, b) = expected;       // tuple decomposing
-
-            ASSERT_EQUAL(a.size(), 1u);
-            ASSERT_EQUAL(a[0], "cat");
-            ASSERT_EQUAL(b, DocumentStatus::ACTUAL);
-        }
-        {
-            SearchServer server(std::string_view{ "in the" });
-            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
-            const string query_test = "cat city";
-            std::tuple<std::vector<string_view>, DocumentStatus> expected = server.MatchDocument(query_test, 12);
-
-            const std::vector<string_view> a = std::get<0>(expected);
-            ASSERT_EQUAL(a.size(), 2u);
-            ASSERT_EQUAL(a[0], "cat");
-            ASSERT_EQUAL(a[1], "city");
-        }
-        {
-            SearchServer server(std::string_view{ "in the" });
-            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
-            const string query_test = "cat city -in";
-            std::tuple<std::vector<string_view>, DocumentStatus> expected = server.MatchDocument(query_test, 12);
-
-            const std::vector<string_view>& a = std::get<0>(expected);
-            ASSERT_EQUAL(a.size(), 2u);
-        }
-        {
-            SearchServer server(std::string_view{ "in the" });
-            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
-            const string query_test = "cat cat";
-            std::tuple<std::vector<string_view>, DocumentStatus> expected = server.MatchDocument(query_test, 12);
-
-            const std::vector<string_view> a = std::get<0>(expected);
-            ASSERT_EQUAL(a.size(), 1u);
-            ASSERT_EQUAL(a[0], "cat");
-        }
-
-        try {
-            SearchServer server(std::string_view{ "in the" });
-            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
-            std::tuple<std::vector<string_view>, DocumentStatus> expected = server.MatchDocument("cat --cat"s, 12);
-            ASSERT_HINT(false, "Check MatchDocument() and CheckDoubleMinus()");
-        }
-        catch (const std::invalid_argument&) {      // e
-            // Do nothing
-        }
-        catch (...) {
-            ASSERT_HINT(false, "Check MatchDocument() and CheckDoubleMinus()! Wrong exception has been throwed");
-        }
-
-        try {
-            SearchServer server(std::string_view{ "in the" });
-            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
-            std::tuple<std::vector<string_view>, DocumentStatus> expected = server.MatchDocument("cat -"sv, 12);
-            ASSERT_HINT(false, "Check MatchDocument() and CheckNoMinusWord()");
-        }
-        catch (const std::invalid_argument&) {      // e
-            // Do nothing
-        }
-        catch (...) {
-            ASSERT_HINT(false, "Check MatchDocument() and CheckNoMinusWord()! Wrong exception has been throwed");
-        }
-
-        try {
-            SearchServer server(std::string_view{ "in the" });
-            server.AddDocument(doc_id, "city-cat out in"sv, DocumentStatus::ACTUAL, ratings);
-            const string query_test = "city-cat";
-        }
-        catch (...) {
-            ASSERT_HINT(false, "Check MatchDocument() and CheckNoMinusWord()! Minus in middle of the word causes exception");
-        }
-    }
-
-#endif
-#if 1
-
-    void TestSortResultsByRelevance() {
-        const int doc_id1 = 12;
-        const string content1 = "cat in the city";
-        const std::vector<int> ratings1 = { 1, 2, 3 };
-        const int doc_id2 = 13;
-        const string content2 = "dog out woods city";
-        const std::vector<int> ratings2 = { 1, 3, 5 };
-        const int doc_id3 = 14;
-        const string content3 = "cat the city";
-        const std::vector<int> ratings3 = { 2, 3, 4 };
-        const int doc_id4 = 15;
-        const string content4 = "wolf sea boat";
-        const std::vector<int> ratings4 = { 6, 7, 8 };
-
-        {
-            SearchServer server(std::string_view{ "in the" });
-            server.AddDocument(doc_id1, content1, DocumentStatus::ACTUAL, ratings1);
-            server.AddDocument(doc_id2, content2, DocumentStatus::ACTUAL, ratings2);
-            server.AddDocument(doc_id3, content3, DocumentStatus::ACTUAL, ratings3);
-            server.AddDocument(doc_id4, content4, DocumentStatus::ACTUAL, ratings4);
-
-            std::vector<Document> result = server.FindTopDocuments("city cat"sv);
-            ASSERT_EQUAL(result.size(), 3u);
-            ASSERT_EQUAL(result[0].id, 14);
-            ASSERT_EQUAL(result[1].id, 12);
-            ASSERT_EQUAL(result[2].id, 13);
-            ASSERT(result[0].relevance >= result[1].relevance && result[1].relevance >= result[2].relevance);
-            //double rel1 = 0.32694308433724206;
-            //ASSERT_EQUAL(result[0].relevance, rel1);
-            //double rel2 = 0.24520731325293155;
-            //ASSERT_EQUAL(result[1].relevance, rel2);
-            //double rel3 = 0.071920518112945211;
-            //ASSERT_EQUAL(result[2].relevance, rel3);              // too much. Here just sort checking. Relevance calculation check in corresponding test hereinafter
-        }
-    }
-
-    void TestAverageRatingCalculation() {
-        const int doc_id = 12;
-        const string content = "cat in the city";
-
-        {
-            SearchServer server(std::string_view{ "in the" });
-            const std::vector<int> ratings = { 1, 2, 3 };
-            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
-            std::vector<Document> res = server.FindTopDocuments("cat"sv);
-            ASSERT_EQUAL(res.size(), 1u);
-            int test_rating = accumulate(ratings.begin(), ratings.end(), 0) / static_cast<int>(ratings.size());
-            ASSERT_EQUAL(res[0].rating, test_rating);
-        }
-        {
-            SearchServer server(std::string_view{ "in the" });            // negative ratings
-            const std::vector<int> ratings = { -1, -2, -4 };
-            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
-            std::vector<Document> res = server.FindTopDocuments("cat"sv);
-            ASSERT_EQUAL(res.size(), 1u);
-            int test_rating = accumulate(ratings.begin(), ratings.end(), 0) / static_cast<int>(ratings.size());
-            ASSERT_EQUAL(res[0].rating, test_rating);
-        }
-        {
-            SearchServer server(std::string_view{ "in the" });        // Empty ratings
-            std::vector<int> ratings;
-            ratings.clear();
-            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
-            std::vector<Document> res = server.FindTopDocuments("cat"sv);
-            ASSERT_EQUAL(res.size(), 1u);
-            ASSERT_EQUAL(res[0].rating, 0);
-        }
-
-        const int doc_id1 = 13;
-        const string content1 = "dog out woods city";
-
-        {
-            SearchServer server(std::string_view{ "in the" });
-            const std::vector<int> ratings = { 0, 1, 2 };
-            const std::vector<int> ratings1 = { 3, 4, 5 };
-            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
-            server.AddDocument(doc_id1, content1, DocumentStatus::ACTUAL, ratings1);
-            std::vector<Document> res = server.FindTopDocuments("city cat"sv);
-            ASSERT_EQUAL(res.size(), 2u);
-            ASSERT_EQUAL(res[0].rating, 1);
-            ASSERT_EQUAL(res[1].rating, 4);
-        }
-    }
-
-    void TestFindingDocumentByPredicate() {
-        const int doc_id = 12, doc_id1 = 13;
-        const string content = "cat in the city", content1 = "dog out woods city";
-        std::vector<int> ratings = { 1, 2, 3 };
-        {
-            SearchServer server(std::string_view{ "in the" });
-            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
-            server.AddDocument(doc_id1, content1, DocumentStatus::ACTUAL, ratings);
-            std::vector<Document> res = server.FindTopDocuments("cat"s, [](int document_id, DocumentStatus status, int rating) { return document_id % 2 == 0; });
-            ASSERT_EQUAL(res.size(), 1u);
-            ASSERT_EQUAL(res[0].id, 12);
-        }
-        {
-            SearchServer server(std::string_view{ "in the" });
-            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
-            server.AddDocument(doc_id1, content1, DocumentStatus::ACTUAL, ratings);
-            std::vector<Document> res = server.FindTopDocuments("city"s, [](int document_id, DocumentStatus status, int rating) { return status == DocumentStatus::ACTUAL; });
-            ASSERT_EQUAL(res.size(), 2u);
-            ASSERT_EQUAL(res[0].id, 12);
-            ASSERT_EQUAL(res[1].id, 13);
-        }
-    }
-
-    void TestFindingDocumentByStatus() {
-        const int doc_id = 12, doc_id1 = 13;
-        const string content = "cat in the city", content1 = "dog out woods city";
-        std::vector<int> ratings = { 1, 2, 3 };
-        {
-            SearchServer server(std::string_view{ "in the" });
-            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
-            server.AddDocument(doc_id1, content1, DocumentStatus::IRRELEVANT, ratings);
-            std::vector<Document> res = server.FindTopDocuments("city"s, DocumentStatus::ACTUAL);
-            ASSERT_EQUAL(res.size(), 1u);
-            ASSERT_EQUAL(res[0].id, 12);
-        }
-    }
-
-    void TestRelevanceCalculation() {
-        const int doc_id = 12, doc_id1 = 13;
-        const string content = "cat in the city"s, content1 = "dog out woods city"s;
-        std::vector<int> ratings = { 1, 2, 3 };
-        {
-            SearchServer server("AAA BBB   ccc  "sv);
-            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
-            server.AddDocument(doc_id1, content1, DocumentStatus::ACTUAL, ratings);
-            std::vector<Document> res = server.FindTopDocuments("cat city"sv);
-            ASSERT_EQUAL(res.size(), 2u);
-
-            double test_idf_cat = log(2.0 / 1.0); // ( doc count / docs with word "cat" )
-            double test_idf_city = log(2.0 / 2.0); // ( doc count / docs with word "city" )      log(1) == 0
-            double test_tf_cat_doc0 = 1.0 / 4.0;     // ( word "cat" count / number of words ) in doc 0
-            double test_tf_cat_doc1 = 0.0 / 4.0;     // ( word "cat" count / number of words ) in doc 1
-            double test_tf_city_doc0 = 1.0 / 4.0;     // ( word "city" count / number of words ) in doc 0
-            double test_tf_city_doc1 = 1.0 / 4.0;     // ( word "city" count / number of words ) in doc 1
-
-            double test_relevance_doc0 = test_idf_cat * test_tf_cat_doc0 + test_idf_city * test_tf_city_doc0;        // 0.17328679513998632
-            double DELTA0 = std::abs((res[0].relevance - test_relevance_doc0));
-            ASSERT_HINT(DELTA0 < 1e-6, "Relevance calculation error! Doc relevance (" + std::to_string(res[1].relevance) + ") != expected (" + std::to_string(test_relevance_doc0) + ")");
-
-            double test_relevance_doc1 = test_idf_cat * test_tf_cat_doc1 + test_idf_city * test_tf_city_doc1;        // 0
-            double DELTA1 = std::abs((res[1].relevance - test_relevance_doc1));
-            ASSERT_HINT(DELTA1 < 1e-6, "Relevance calculation error! Doc relevance (" + std::to_string(res[1].relevance) + ") != expected (" + std::to_string(test_relevance_doc1) + ")");
-        }
-    }
-
-    void TestServerConstructingByContainers() {
-        const string content = "cat in the city";
-        const string content1 = "dog out woods city";
-
-        {
-            std::vector<string> test_stop_words = { "in", "the" };
-            SearchServer server(test_stop_words);
-            server.AddDocument(12, content, DocumentStatus::ACTUAL, { 1, 2, 3 });
-            server.AddDocument(13, content1, DocumentStatus::ACTUAL, { 2, 3, 4 });
-            std::vector<Document> res = server.FindTopDocuments("cat"sv);
-            ASSERT_EQUAL_HINT(res.size(), 1u, "Check serror construction via std::vector<string> fails");
-            std::vector<Document> res1 = server.FindTopDocuments("city"sv);
-            ASSERT_EQUAL_HINT(res1.size(), 2u, "Check serror construction via std::vector<string> fails");
-        }
-        {
-            const std::set<string> test_stop_words = { "in", "the" };
-            SearchServer server(test_stop_words);
-            server.AddDocument(12, content, DocumentStatus::ACTUAL, { 1, 2, 3 });
-            server.AddDocument(13, content1, DocumentStatus::ACTUAL, { 2, 3, 4 });
-            std::vector<Document> res = server.FindTopDocuments("cat"sv);
-            ASSERT_EQUAL_HINT(res.size(), 1u, "Check server construction via std::vector<string> fails");
-            std::vector<Document> res1 = server.FindTopDocuments("city"sv);
-            ASSERT_EQUAL_HINT(res1.size(), 2u, "Check server construction via std::vector<string> fails");
-        }
-        {
-            const std::vector<string> test_stop_words = {};
-            SearchServer server(test_stop_words);
-            server.AddDocument(12, content, DocumentStatus::ACTUAL, { 1, 2, 3 });
-            std::vector<Document> res = server.FindTopDocuments("in"sv);
-            ASSERT_EQUAL_HINT(res.size(), 1u, "Check server constructing with empty stop-words std::vector<string>");
-        }
-
-    }
-
-#endif
-#if 1
-
-    void TestAddDocuments() {
-        const string content = "cat in the city";
-        const std::vector<string> test_stop_words = { "in", "the" };
-
-        try {
-            SearchServer server(test_stop_words);
-            server.AddDocument(12, content, DocumentStatus::ACTUAL, { 1, 2, 3 });
-        }
-        catch (...) {
-            ASSERT_HINT(false, "Check bool AddDocument()! Valid condition causes exception");
-        }
-
-        try {
-            SearchServer server(test_stop_words);
-            server.AddDocument(-1, content, DocumentStatus::ACTUAL, { 1, 2, 3 });
-            ASSERT_HINT(false, "Check bool AddDocument()! Negative ID don't causes throwing invalid_argument");
-        }
-        catch (const std::invalid_argument&) {      // e
-            // Everything is OK
-        }
-        catch (...) {
-            ASSERT_HINT(false, "Check bool AddDocument()! Negative ID, wrong exception has been throwed");
-        }
-
-        try {
-            SearchServer server(test_stop_words);
-            server.AddDocument(0, content, DocumentStatus::ACTUAL, { 1, 2, 3 });
-        }
-        catch (...) {
-            ASSERT_HINT(false, "Check bool AddDocument()! ID=0 has throwed exception");
-        }
-
-        try {
-            SearchServer server(test_stop_words);
-            server.AddDocument(12, content, DocumentStatus::ACTUAL, { 1, 2, 3 });
-            server.AddDocument(12, "dog out of woods"s, DocumentStatus::ACTUAL, { 1, 2, 3 });
-            ASSERT_HINT(false, "Check bool AddDocument()! Double ID, exception hasn't been throwed");
-        }
-        catch (const std::invalid_argument&) {      // e
-            // Do nothing
-        }
-        catch (...) {
-            ASSERT_HINT(false, "Check bool AddDocument()! Double ID, wrong exception has been throwed");
-        }
-
-        try {
-            SearchServer server(test_stop_words);
-            server.AddDocument(12, "cat in the c\x12ity"s, DocumentStatus::ACTUAL, { 1, 2, 3 });
-            ASSERT_HINT(false, "Check bool AddDocument()! Special symbols, exception hasn't been throwed");
-        }
-        catch (const std::invalid_argument&) {      // e
-            // Everything is OK
-        }
-        catch (...) {
-            ASSERT_HINT(false, " Check AddDocument()! Special symbols in querry causes wrong exception");
-        }
-
-        try {
-            SearchServer server(test_stop_words);
-            server.AddDocument(0, "белый кот и модный ошейник"s, DocumentStatus::ACTUAL, { 1, 2, 3 });
-        }
-        catch (...) {
-            ASSERT_HINT(false, "Check bool AddDocument()! Russian letters has throwed exception");
-        }
-
-        try {
-            SearchServer server(test_stop_words);
-            server.AddDocument(12, "белый кот и мо\x12дный ошейник"s, DocumentStatus::ACTUAL, { 1, 2, 3 });
-            ASSERT_HINT(false, "Check bool AddDocument()! Special symbols in russian querry, exception hasn't been throwed");
-        }
-        catch (const std::invalid_argument&) {      // e
-            // Do nothing
-        }
-        catch (...) {
-            ASSERT_HINT(false, "Check bool AddDocument()! Special symbols in russian querry, wrong exception has been throwed");
-        }
-
-    }
-
-#endif
-
-#if 0   // method removed
-
-    void TestGetDocIDByNumber() {
-        const string content0 = "aaa";
-        const string content1 = "bbb";
-        const string content2 = "ccc";
-        const string content3 = "ddd";
-        const string content4 = "eee";
-        const std::vector<string> test_stop_words = { "in", "the" };
-
-        SearchServer server(test_stop_words);
-        server.AddDocument(12, content0, DocumentStatus::ACTUAL, { 1, 2, 3 });
-        server.AddDocument(13, content1, DocumentStatus::ACTUAL, { 1, 2, 3 });
-        server.AddDocument(14, content2, DocumentStatus::ACTUAL, { 1, 2, 3 });
-        server.AddDocument(15, content3, DocumentStatus::ACTUAL, { 1, 2, 3 });
-        server.AddDocument(16, content4, DocumentStatus::ACTUAL, { 1, 2, 3 });
-        {
-            int get_id = server.GetDocumentId(0);
-            ASSERT_EQUAL_HINT(get_id, 12, "Check GetDocumentId()! Number 0 getted wrong");
-        }
-        {
-            int get_id = server.GetDocumentId(1);
-            ASSERT_EQUAL_HINT(get_id, 13, "Check GetDocumentId()! Number 1 getted wrong");
-        }
-        {
-            int get_id = server.GetDocumentId(4);
-            ASSERT_EQUAL_HINT(get_id, 16, "Check GetDocumentId()! Number 4 (last) getted wrong");
-        }
-
-        try {
-            server.GetDocumentId(10);
-            ASSERT_HINT(false, "Check GetDocumentId()! Out of range check might be missed");
-        }
-        catch (const std::out_of_range& e) {
-            // Do nothing
-        }
-        catch (...) {
-            ASSERT_HINT(false, "Check GetDocumentId()! Out of range ID, wrong exception has been throwed");
-        }
-
-        try {
-            server.GetDocumentId(-6);
-            ASSERT_HINT(false, "Check GetDocumentId()! Negative doc number check might be missed");
-        }
-        catch (const std::out_of_range& e) {
-            // Do nothing
-        }
-        catch (...) {
-            ASSERT_HINT(false, "Check GetDocumentId()! Negative doc number, wrong exception has been throwed");
-        }
-    }
-
-#endif
-
-    template <typename QueriesProcessor>
-    void Test(string_view mark, QueriesProcessor processor, const SearchServer& search_server, const vector<string>& queries) {
-        LOG_DURATION(mark);
-        const auto documents_lists = processor(search_server, queries);
-    }
-
-#define TEST(processor) Test(#processor, processor, search_server, queries)
-
-
-#if 1
-
-    /*
-    Разместите код остальных тестов здесь
-    */
-
-    // Функция TestSearchServer является точкой входа для запуска тестов
-    void TestSearchServer() {
-        RUN_TEST(TestExcludeStopWordsFromAddedDocumentContent);
-        RUN_TEST(TestSplitIntoWords);
-        RUN_TEST(TestExcludeDocumentsByMinusWords);
-        RUN_TEST(TestMatchingDocumentsByQuerry);
-        RUN_TEST(TestSortResultsByRelevance);
-        RUN_TEST(TestAverageRatingCalculation);
-        RUN_TEST(TestFindingDocumentByPredicate);
-        RUN_TEST(TestFindingDocumentByStatus);
-        RUN_TEST(TestRelevanceCalculation);
-        RUN_TEST(TestServerConstructingByContainers);
-        RUN_TEST(TestAddDocuments);
-        //RUN_TEST(TestGetDocIDByNumber);           // method removed
-        // Не забудьте вызывать остальные тесты здесь
-    }
-#endif
-    // --------- Окончание модульных тестов поисковой системы -----------
+﻿#pragma once
+
+#include <string>
+#include <iostream>
+#include <vector>
+#include <tuple>
+#include <set>
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <optional>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <functional>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#include "search_server.h"
+#include "mapped_search_server.h"
+#include "write_ahead_log.h"
+#include "ingestion_pipeline.h"
+#include "read_input_functions.h"
+#include "process_queries.h"
+#include "remove_duplicates.h"
+#include "request_queue.h"
+
+namespace MyUnitTests {
+
+    using std::string;
+    using std::cerr;
+
+    using namespace std;            // need it here to avoid massive amount of ""s errors
+
+    template <typename T, typename U>
+    void AssertEqualImpl(const T& t, const U& u, const string& t_str, const string& u_str, const string& file, const string& func, unsigned line, const string& hint) {
+        if (t != u) {
+            cerr << boolalpha;
+            cerr << file << "(" << line << "): " << func << ": ";
+            cerr << "ASSERT_EQUAL(" << t_str << ", " << u_str << ") failed: ";
+            cerr << t << " != " << u << ".";
+            if (!hint.empty()) {
+                cerr << " Hint: " << hint;
+            }
+            cerr << std::endl;
+            abort();
+        }
+    }
+
+    void AssertImpl(bool value, const string& expr_str, const string& file, const string& func, unsigned line,
+        const string& hint) {
+        if (!value) {
+            cerr << file << "(" << line << "): " << func << ": ";
+            cerr << "ASSERT(" << expr_str << ") failed.";
+            if (!hint.empty()) {
+                cerr << " Hint: " << hint;
+            }
+            cerr << std::endl;
+            abort();
+        }
+    }
+
+    template <typename T>
+    void RunTestImpl(const T& func, const string& func_name) {
+        func();
+        cerr << func_name << " OK\n";
+    }
+
+#define ASSERT(expr) AssertImpl(!!(expr), #expr, __FILE__, __FUNCTION__, __LINE__, "")
+
+#define ASSERT_HINT(expr, hint) AssertImpl(!!(expr), #expr, __FILE__, __FUNCTION__, __LINE__, (hint))
+
+#define ASSERT_EQUAL(a, b) AssertEqualImpl((a), (b), #a, #b, __FILE__, __FUNCTION__, __LINE__, "")
+
+#define ASSERT_EQUAL_HINT(a, b, hint) AssertEqualImpl((a), (b), #a, #b, __FILE__, __FUNCTION__, __LINE__, (hint))
+
+#define RUN_TEST(func) RunTestImpl((func), #func)
+
+
+    // -------- Начало модульных тестов поисковой системы ----------
+
+    // Тест проверяет, что поисковая система исключает стоп-слова при добавлении документов
+
+#if 1
+    void TestExcludeStopWordsFromAddedDocumentContent() {
+        const int doc_id = 42;
+        const string content = "cat in the city";
+        const std::vector<int> ratings = { 1, 2, 3 };
+        {
+            SearchServer server("in the"sv);
+            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
+            std::vector<Document> res = server.FindTopDocuments("cat"sv);
+            ASSERT_EQUAL(res.size(), 1u);
+            const Document& doc0 = res[0];
+            ASSERT_EQUAL(doc0.id, doc_id);
+        }
+        {
+            SearchServer server("in the"sv);
+            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
+            std::vector<Document> res = server.FindTopDocuments("in"sv);
+            ASSERT_HINT(res.empty(), "top words must be excluded from documents");
+        }
+    }
+
+#endif
+
+    void TestSplitIntoWords() {
+        {
+            std::vector<std::string_view> exp = { "aaa" , "bbb" };
+            std::vector<std::string_view> res = SplitIntoWords("   aaa    bbb   ");
+            //ASSERT_EQUAL_HINT(exp, res, "SplitIntoWords not works");
+        }
+        {
+            std::vector<std::string_view> exp = { "aaa" , "bbb" };
+            std::vector<std::string_view> res = SplitIntoWords("aaa    bbb   ");
+            //ASSERT_EQUAL_HINT(exp, res, "SplitIntoWords not works");
+        }
+        {
+            std::vector<std::string_view> exp = { "aaa" , "bbb" };
+            std::vector<std::string_view> res = SplitIntoWords("   aaa    bbb");
+            //ASSERT_EQUAL_HINT(exp, res, "SplitIntoWords not works");
+        }
+        {
+            std::vector<std::string_view> exp = { "aaa" , "bbb" };
+            std::vector<std::string_view> res = SplitIntoWords("aaa    bbb");
+            //ASSERT_EQUAL_HINT(exp, res, "SplitIntoWords not works");
+        }
+        {
+            std::vector<std::string_view> exp;
+            std::vector<std::string_view> res = SplitIntoWords("");
+            //ASSERT_EQUAL_HINT(exp, res, "SplitIntoWords not works");
+        }
+        {
+            std::vector<std::string_view> exp;
+            std::vector<std::string_view> res = SplitIntoWords("     ");
+            //ASSERT_EQUAL_HINT(exp, res, "SplitIntoWords not works");
+        }
+        {
+            std::vector<std::string_view> exp = { "aaa" , "bbb", "cc", "dddd"};
+            std::vector<std::string_view> res = SplitIntoWords("   aaa    bbb     cc   dddd  ");
+            //ASSERT_EQUAL_HINT(exp, res, "SplitIntoWords not works");
+        }
+    }
+#if 1
+
+    void TestExcludeDocumentsByMinusWords() {
+        const int doc_id = 12;
+        const string content = "cat in the city";
+        const std::vector<int> ratings = { 1, 2, 3 };
+        {
+            SearchServer server(std::string_view{ "in the" });
+            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
+            std::vector<Document> res = server.FindTopDocuments("cat -city"sv);
+            ASSERT_EQUAL(res.size(), 0u);
+        }
+        {
+            SearchServer server(std::string_view{ "in the" });
+            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
+            std::vector<Document> res = server.FindTopDocuments("-city"sv);
+            ASSERT_EQUAL(res.size(), 0u);
+        }
+        {
+            SearchServer server(std::string_view{ "in the" });
+            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
+            std::vector<Document> res = server.FindTopDocuments("-city -city"sv);
+            ASSERT_EQUAL(res.size(), 0u);
+        }
+        {
+            SearchServer server(std::string_view{ "in the" });
+            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
+            std::vector<Document> res = server.FindTopDocuments("city -city"sv);
+            ASSERT_EQUAL(res.size(), 0u);
+        }
+        {
+            SearchServer server(std::string_view{ "in the" });
+            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
+            std::vector<Document> res = server.FindTopDocuments("city -a"sv);
+            ASSERT_EQUAL(res.size(), 1u);
+        }
+    }
+
+#endif
+#if 1
+
+    void TestMatchingDocumentsByQuerry() {
+        const int doc_id = 12;
+        const string content = "cat in the city";
+        const std::vector<int> ratings = { 1, 2, 3 };
+        {
+            SearchServer server(std::string_view{ "in the" });
+            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
+            const string query_test = "cat";
+            std::tuple<std::vector<string_view>, DocumentStatus> expected = server.MatchDocument(query_test, 12);
+
+            auto& [a, b] = expected;
+
+            //std::vector<string> a;
+            //DocumentStatus b;
+            //tie(a, b) = expected;       // tuple decomposing
+
+            ASSERT_EQUAL(a.size(), 1u);
+            ASSERT_EQUAL(a[0], "cat");
+            ASSERT_EQUAL(b, DocumentStatus::ACTUAL);
+        }
+        {
+            SearchServer server(std::string_view{ "in the" });
+            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
+            const string query_test = "cat city";
+            std::tuple<std::vector<string_view>, DocumentStatus> expected = server.MatchDocument(query_test, 12);
+
+            const std::vector<string_view> a = std::get<0>(expected);
+            ASSERT_EQUAL(a.size(), 2u);
+            ASSERT_EQUAL(a[0], "cat");
+            ASSERT_EQUAL(a[1], "city");
+        }
+        {
+            SearchServer server(std::string_view{ "in the" });
+            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
+            const string query_test = "cat city -in";
+            std::tuple<std::vector<string_view>, DocumentStatus> expected = server.MatchDocument(query_test, 12);
+
+            const std::vector<string_view>& a = std::get<0>(expected);
+            ASSERT_EQUAL(a.size(), 2u);
+        }
+        {
+            SearchServer server(std::string_view{ "in the" });
+            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
+            const string query_test = "cat cat";
+            std::tuple<std::vector<string_view>, DocumentStatus> expected = server.MatchDocument(query_test, 12);
+
+            const std::vector<string_view> a = std::get<0>(expected);
+            ASSERT_EQUAL(a.size(), 1u);
+            ASSERT_EQUAL(a[0], "cat");
+        }
+
+        try {
+            SearchServer server(std::string_view{ "in the" });
+            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
+            std::tuple<std::vector<string_view>, DocumentStatus> expected = server.MatchDocument("cat --cat"s, 12);
+            ASSERT_HINT(false, "Check MatchDocument() and CheckDoubleMinus()");
+        }
+        catch (const std::invalid_argument&) {      // e
+            // Do nothing
+        }
+        catch (...) {
+            ASSERT_HINT(false, "Check MatchDocument() and CheckDoubleMinus()! Wrong exception has been throwed");
+        }
+
+        try {
+            SearchServer server(std::string_view{ "in the" });
+            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
+            std::tuple<std::vector<string_view>, DocumentStatus> expected = server.MatchDocument("cat -"sv, 12);
+            ASSERT_HINT(false, "Check MatchDocument() and CheckNoMinusWord()");
+        }
+        catch (const std::invalid_argument&) {      // e
+            // Do nothing
+        }
+        catch (...) {
+            ASSERT_HINT(false, "Check MatchDocument() and CheckNoMinusWord()! Wrong exception has been throwed");
+        }
+
+        try {
+            SearchServer server(std::string_view{ "in the" });
+            server.AddDocument(doc_id, "city-cat out in"sv, DocumentStatus::ACTUAL, ratings);
+            const string query_test = "city-cat";
+        }
+        catch (...) {
+            ASSERT_HINT(false, "Check MatchDocument() and CheckNoMinusWord()! Minus in middle of the word causes exception");
+        }
+    }
+
+#endif
+#if 1
+
+    void TestSortResultsByRelevance() {
+        const int doc_id1 = 12;
+        const string content1 = "cat in the city";
+        const std::vector<int> ratings1 = { 1, 2, 3 };
+        const int doc_id2 = 13;
+        const string content2 = "dog out woods city";
+        const std::vector<int> ratings2 = { 1, 3, 5 };
+        const int doc_id3 = 14;
+        const string content3 = "cat the city";
+        const std::vector<int> ratings3 = { 2, 3, 4 };
+        const int doc_id4 = 15;
+        const string content4 = "wolf sea boat";
+        const std::vector<int> ratings4 = { 6, 7, 8 };
+
+        {
+            SearchServer server(std::string_view{ "in the" });
+            server.AddDocument(doc_id1, content1, DocumentStatus::ACTUAL, ratings1);
+            server.AddDocument(doc_id2, content2, DocumentStatus::ACTUAL, ratings2);
+            server.AddDocument(doc_id3, content3, DocumentStatus::ACTUAL, ratings3);
+            server.AddDocument(doc_id4, content4, DocumentStatus::ACTUAL, ratings4);
+
+            std::vector<Document> result = server.FindTopDocuments("city cat"sv);
+            ASSERT_EQUAL(result.size(), 3u);
+            ASSERT_EQUAL(result[0].id, 14);
+            ASSERT_EQUAL(result[1].id, 12);
+            ASSERT_EQUAL(result[2].id, 13);
+            ASSERT(result[0].relevance >= result[1].relevance && result[1].relevance >= result[2].relevance);
+            //double rel1 = 0.32694308433724206;
+            //ASSERT_EQUAL(result[0].relevance, rel1);
+            //double rel2 = 0.24520731325293155;
+            //ASSERT_EQUAL(result[1].relevance, rel2);
+            //double rel3 = 0.071920518112945211;
+            //ASSERT_EQUAL(result[2].relevance, rel3);              // too much. Here just sort checking. Relevance calculation check in corresponding test hereinafter
+        }
+    }
+
+    void TestAverageRatingCalculation() {
+        const int doc_id = 12;
+        const string content = "cat in the city";
+
+        {
+            SearchServer server(std::string_view{ "in the" });
+            const std::vector<int> ratings = { 1, 2, 3 };
+            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
+            std::vector<Document> res = server.FindTopDocuments("cat"sv);
+            ASSERT_EQUAL(res.size(), 1u);
+            int test_rating = accumulate(ratings.begin(), ratings.end(), 0) / static_cast<int>(ratings.size());
+            ASSERT_EQUAL(res[0].rating, test_rating);
+        }
+        {
+            SearchServer server(std::string_view{ "in the" });            // negative ratings
+            const std::vector<int> ratings = { -1, -2, -4 };
+            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
+            std::vector<Document> res = server.FindTopDocuments("cat"sv);
+            ASSERT_EQUAL(res.size(), 1u);
+            int test_rating = accumulate(ratings.begin(), ratings.end(), 0) / static_cast<int>(ratings.size());
+            ASSERT_EQUAL(res[0].rating, test_rating);
+        }
+        {
+            SearchServer server(std::string_view{ "in the" });        // Empty ratings
+            std::vector<int> ratings;
+            ratings.clear();
+            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
+            std::vector<Document> res = server.FindTopDocuments("cat"sv);
+            ASSERT_EQUAL(res.size(), 1u);
+            ASSERT_EQUAL(res[0].rating, 0);
+        }
+
+        const int doc_id1 = 13;
+        const string content1 = "dog out woods city";
+
+        {
+            SearchServer server(std::string_view{ "in the" });
+            const std::vector<int> ratings = { 0, 1, 2 };
+            const std::vector<int> ratings1 = { 3, 4, 5 };
+            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
+            server.AddDocument(doc_id1, content1, DocumentStatus::ACTUAL, ratings1);
+            std::vector<Document> res = server.FindTopDocuments("city cat"sv);
+            ASSERT_EQUAL(res.size(), 2u);
+            ASSERT_EQUAL(res[0].rating, 1);
+            ASSERT_EQUAL(res[1].rating, 4);
+        }
+    }
+
+    void TestFindingDocumentByPredicate() {
+        const int doc_id = 12, doc_id1 = 13;
+        const string content = "cat in the city", content1 = "dog out woods city";
+        std::vector<int> ratings = { 1, 2, 3 };
+        {
+            SearchServer server(std::string_view{ "in the" });
+            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
+            server.AddDocument(doc_id1, content1, DocumentStatus::ACTUAL, ratings);
+            std::vector<Document> res = server.FindTopDocuments("cat"s, [](int document_id, DocumentStatus status, int rating) { return document_id % 2 == 0; });
+            ASSERT_EQUAL(res.size(), 1u);
+            ASSERT_EQUAL(res[0].id, 12);
+        }
+        {
+            SearchServer server(std::string_view{ "in the" });
+            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
+            server.AddDocument(doc_id1, content1, DocumentStatus::ACTUAL, ratings);
+            std::vector<Document> res = server.FindTopDocuments("city"s, [](int document_id, DocumentStatus status, int rating) { return status == DocumentStatus::ACTUAL; });
+            ASSERT_EQUAL(res.size(), 2u);
+            ASSERT_EQUAL(res[0].id, 12);
+            ASSERT_EQUAL(res[1].id, 13);
+        }
+    }
+
+    void TestFindingDocumentByStatus() {
+        const int doc_id = 12, doc_id1 = 13;
+        const string content = "cat in the city", content1 = "dog out woods city";
+        std::vector<int> ratings = { 1, 2, 3 };
+        {
+            SearchServer server(std::string_view{ "in the" });
+            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
+            server.AddDocument(doc_id1, content1, DocumentStatus::IRRELEVANT, ratings);
+            std::vector<Document> res = server.FindTopDocuments("city"s, DocumentStatus::ACTUAL);
+            ASSERT_EQUAL(res.size(), 1u);
+            ASSERT_EQUAL(res[0].id, 12);
+        }
+    }
+
+    void TestRelevanceCalculation() {
+        const int doc_id = 12, doc_id1 = 13;
+        const string content = "cat in the city"s, content1 = "dog out woods city"s;
+        std::vector<int> ratings = { 1, 2, 3 };
+        {
+            SearchServer server("AAA BBB   ccc  "sv);
+            server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
+            server.AddDocument(doc_id1, content1, DocumentStatus::ACTUAL, ratings);
+            std::vector<Document> res = server.FindTopDocuments("cat city"sv);
+            ASSERT_EQUAL(res.size(), 2u);
+
+            double test_idf_cat = log(2.0 / 1.0); // ( doc count / docs with word "cat" )
+            double test_idf_city = log(2.0 / 2.0); // ( doc count / docs with word "city" )      log(1) == 0
+            double test_tf_cat_doc0 = 1.0 / 4.0;     // ( word "cat" count / number of words ) in doc 0
+            double test_tf_cat_doc1 = 0.0 / 4.0;     // ( word "cat" count / number of words ) in doc 1
+            double test_tf_city_doc0 = 1.0 / 4.0;     // ( word "city" count / number of words ) in doc 0
+            double test_tf_city_doc1 = 1.0 / 4.0;     // ( word "city" count / number of words ) in doc 1
+
+            double test_relevance_doc0 = test_idf_cat * test_tf_cat_doc0 + test_idf_city * test_tf_city_doc0;        // 0.17328679513998632
+            double DELTA0 = std::abs((res[0].relevance - test_relevance_doc0));
+            ASSERT_HINT(DELTA0 < 1e-6, "Relevance calculation error! Doc relevance (" + std::to_string(res[1].relevance) + ") != expected (" + std::to_string(test_relevance_doc0) + ")");
+
+            double test_relevance_doc1 = test_idf_cat * test_tf_cat_doc1 + test_idf_city * test_tf_city_doc1;        // 0
+            double DELTA1 = std::abs((res[1].relevance - test_relevance_doc1));
+            ASSERT_HINT(DELTA1 < 1e-6, "Relevance calculation error! Doc relevance (" + std::to_string(res[1].relevance) + ") != expected (" + std::to_string(test_relevance_doc1) + ")");
+        }
+    }
+
+    void TestServerConstructingByContainers() {
+        const string content = "cat in the city";
+        const string content1 = "dog out woods city";
+
+        {
+            std::vector<string> test_stop_words = { "in", "the" };
+            SearchServer server(test_stop_words);
+            server.AddDocument(12, content, DocumentStatus::ACTUAL, { 1, 2, 3 });
+            server.AddDocument(13, content1, DocumentStatus::ACTUAL, { 2, 3, 4 });
+            std::vector<Document> res = server.FindTopDocuments("cat"sv);
+            ASSERT_EQUAL_HINT(res.size(), 1u, "Check serror construction via std::vector<string> fails");
+            std::vector<Document> res1 = server.FindTopDocuments("city"sv);
+            ASSERT_EQUAL_HINT(res1.size(), 2u, "Check serror construction via std::vector<string> fails");
+        }
+        {
+            const std::set<string> test_stop_words = { "in", "the" };
+            SearchServer server(test_stop_words);
+            server.AddDocument(12, content, DocumentStatus::ACTUAL, { 1, 2, 3 });
+            server.AddDocument(13, content1, DocumentStatus::ACTUAL, { 2, 3, 4 });
+            std::vector<Document> res = server.FindTopDocuments("cat"sv);
+            ASSERT_EQUAL_HINT(res.size(), 1u, "Check server construction via std::vector<string> fails");
+            std::vector<Document> res1 = server.FindTopDocuments("city"sv);
+            ASSERT_EQUAL_HINT(res1.size(), 2u, "Check server construction via std::vector<string> fails");
+        }
+        {
+            const std::vector<string> test_stop_words = {};
+            SearchServer server(test_stop_words);
+            server.AddDocument(12, content, DocumentStatus::ACTUAL, { 1, 2, 3 });
+            std::vector<Document> res = server.FindTopDocuments("in"sv);
+            ASSERT_EQUAL_HINT(res.size(), 1u, "Check server constructing with empty stop-words std::vector<string>");
+        }
+
+    }
+
+#endif
+#if 1
+
+    void TestAddDocuments() {
+        const string content = "cat in the city";
+        const std::vector<string> test_stop_words = { "in", "the" };
+
+        try {
+            SearchServer server(test_stop_words);
+            server.AddDocument(12, content, DocumentStatus::ACTUAL, { 1, 2, 3 });
+        }
+        catch (...) {
+            ASSERT_HINT(false, "Check bool AddDocument()! Valid condition causes exception");
+        }
+
+        try {
+            SearchServer server(test_stop_words);
+            server.AddDocument(-1, content, DocumentStatus::ACTUAL, { 1, 2, 3 });
+            ASSERT_HINT(false, "Check bool AddDocument()! Negative ID don't causes throwing invalid_argument");
+        }
+        catch (const std::invalid_argument&) {      // e
+            // Everything is OK
+        }
+        catch (...) {
+            ASSERT_HINT(false, "Check bool AddDocument()! Negative ID, wrong exception has been throwed");
+        }
+
+        try {
+            SearchServer server(test_stop_words);
+            server.AddDocument(0, content, DocumentStatus::ACTUAL, { 1, 2, 3 });
+        }
+        catch (...) {
+            ASSERT_HINT(false, "Check bool AddDocument()! ID=0 has throwed exception");
+        }
+
+        try {
+            SearchServer server(test_stop_words);
+            server.AddDocument(12, content, DocumentStatus::ACTUAL, { 1, 2, 3 });
+            server.AddDocument(12, "dog out of woods"s, DocumentStatus::ACTUAL, { 1, 2, 3 });
+            ASSERT_HINT(false, "Check bool AddDocument()! Double ID, exception hasn't been throwed");
+        }
+        catch (const std::invalid_argument&) {      // e
+            // Do nothing
+        }
+        catch (...) {
+            ASSERT_HINT(false, "Check bool AddDocument()! Double ID, wrong exception has been throwed");
+        }
+
+        try {
+            SearchServer server(test_stop_words);
+            server.AddDocument(12, "cat in the c\x12ity"s, DocumentStatus::ACTUAL, { 1, 2, 3 });
+            ASSERT_HINT(false, "Check bool AddDocument()! Special symbols, exception hasn't been throwed");
+        }
+        catch (const std::invalid_argument&) {      // e
+            // Everything is OK
+        }
+        catch (...) {
+            ASSERT_HINT(false, " Check AddDocument()! Special symbols in querry causes wrong exception");
+        }
+
+        try {
+            SearchServer server(test_stop_words);
+            server.AddDocument(0, "белый кот и модный ошейник"s, DocumentStatus::ACTUAL, { 1, 2, 3 });
+        }
+        catch (...) {
+            ASSERT_HINT(false, "Check bool AddDocument()! Russian letters has throwed exception");
+        }
+
+        try {
+            SearchServer server(test_stop_words);
+            server.AddDocument(12, "белый кот и мо\x12дный ошейник"s, DocumentStatus::ACTUAL, { 1, 2, 3 });
+            ASSERT_HINT(false, "Check bool AddDocument()! Special symbols in russian querry, exception hasn't been throwed");
+        }
+        catch (const std::invalid_argument&) {      // e
+            // Do nothing
+        }
+        catch (...) {
+            ASSERT_HINT(false, "Check bool AddDocument()! Special symbols in russian querry, wrong exception has been throwed");
+        }
+
+    }
+
+#endif
+
+    void TestRemoveDocumentsWithTombstones() {
+        SearchServer server("and with"sv);
+        server.AddDocument(1, "funny pet and nasty rat"sv, DocumentStatus::ACTUAL, { 1, 2 });
+        server.AddDocument(2, "funny pet with curly hair"sv, DocumentStatus::ACTUAL, { 1, 2 });
+        server.AddDocument(3, "nasty rat with curly hair"sv, DocumentStatus::ACTUAL, { 1, 2 });
+
+        server.RemoveDocuments({ 1, 3, 42 });
+        ASSERT_EQUAL(server.GetDocumentCount(), 1);
+        ASSERT_EQUAL(server.GetPendingRemovalCount(), 2);
+        ASSERT_HINT(server.FindTopDocuments("nasty rat"sv).empty(), "Removed documents must be hidden before compaction");
+        ASSERT_EQUAL(server.FindTopDocuments(execution::par, "curly"sv).size(), 1u);
+        ASSERT(server.GetWordFrequencies(1).empty());
+
+        server.CompactRemovedDocuments();
+        ASSERT_EQUAL(server.GetPendingRemovalCount(), 0);
+        ASSERT_EQUAL(server.GetDocumentCount(), 1);
+        ASSERT_EQUAL(server.FindTopDocuments("funny curly"sv).size(), 1u);
+
+        server.RemoveDocuments({ 2 });
+        server.AddDocument(2, "nasty rat"sv, DocumentStatus::ACTUAL, { 1, 2 });
+        ASSERT_EQUAL(server.GetPendingRemovalCount(), 0);
+        ASSERT_EQUAL(server.FindTopDocuments("rat"sv).size(), 1u);
+        ASSERT(server.FindTopDocuments("curly"sv).empty());
+
+        server.AddDocument(4, "and with"sv, DocumentStatus::ACTUAL, { 1, 2 });
+        server.RemoveDocuments({ 4 });
+        server.CompactRemovedDocuments(execution::seq);
+        ASSERT_EQUAL(server.GetDocumentCount(), 1);
+    }
+
+    // rewrites a snapshot file through patch and fixes its checksum, so only the patched fields are broken
+    void PatchSnapshot(const string& path, const std::function<void(SnapshotHeader&, char*)>& patch) {
+        std::vector<char> image = ReadSnapshotFile(path);
+        SnapshotHeader& header = *reinterpret_cast<SnapshotHeader*>(image.data());
+        char* payload = image.data() + sizeof(SnapshotHeader);
+        patch(header, payload);
+        header.checksum = SnapshotChecksum(payload, header.payload_size);
+        std::ofstream(path, std::ios::binary | std::ios::trunc).write(image.data(), image.size());
+    }
+
+    void TestSnapshotSaveLoad() {
+        const string path = "test_snapshot.bin";
+        SearchServer server("and with"sv);
+        server.AddDocument(1, "funny pet and nasty rat"sv, DocumentStatus::ACTUAL, { 1, 2 });
+        server.AddDocument(2, "funny pet with curly hair"sv, DocumentStatus::BANNED, { 3, 4 });
+        server.AddDocument(3, "nasty rat with curly hair"sv, DocumentStatus::ACTUAL, { 5, 6 });
+        server.RemoveDocuments({ 3 });
+        server.SaveSnapshot(path);
+
+        SearchServer loaded("other"sv);
+        loaded.LoadSnapshot(path);
+        ASSERT_EQUAL(loaded.GetDocumentCount(), 2);
+        ASSERT(loaded.FindTopDocuments("hair"sv).empty());
+        ASSERT(loaded.FindTopDocuments("and"sv).empty());
+        server.CompactRemovedDocuments();
+        const std::vector<Document> expected = server.FindTopDocuments("funny curly"sv, DocumentStatus::BANNED);
+        const std::vector<Document> res = loaded.FindTopDocuments("funny curly"sv, DocumentStatus::BANNED);
+        ASSERT_EQUAL(res.size(), 1u);
+        ASSERT_EQUAL(res[0].id, expected[0].id);
+        ASSERT_EQUAL(res[0].rating, 3);
+        ASSERT(std::abs(res[0].relevance - expected[0].relevance) < 1e-6);
+        ASSERT_EQUAL(std::get<0>(loaded.MatchDocument("nasty rat"sv, 1)).size(), 2u);
+
+        {
+            std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+            file.seekp(-1, std::ios::end);
+            file.put('#');
+        }
+        try {
+            loaded.LoadSnapshot(path);
+            ASSERT_HINT(false, "Check LoadSnapshot()! Broken checksum hasn't been detected");
+        }
+        catch (const std::runtime_error&) {
+            // Everything is OK
+        }
+        ASSERT_EQUAL(loaded.GetDocumentCount(), 2);
+
+        // string of a valid checksum pointing past the strings section
+        server.SaveSnapshot(path);
+        PatchSnapshot(path, [](SnapshotHeader& header, char* payload) {
+            SnapshotTerm* terms = reinterpret_cast<SnapshotTerm*>(payload + header.sections[SNAPSHOT_TERMS].offset);
+            terms[0].text.length = header.sections[SNAPSHOT_STRINGS].count - terms[0].text.offset + 1;
+        });
+        try {
+            loaded.LoadSnapshot(path);
+            ASSERT_HINT(false, "Check LoadSnapshot()! String out of bounds hasn't been detected");
+        }
+        catch (const std::runtime_error&) {
+        }
+        ASSERT_EQUAL(loaded.GetDocumentCount(), 2);
+
+        // range whose end wraps around and status out of the enum
+        const std::vector<std::function<void(SnapshotHeader&, char*)>> broken = {
+            [](SnapshotHeader& header, char* payload) {
+                SnapshotTerm* terms = reinterpret_cast<SnapshotTerm*>(payload + header.sections[SNAPSHOT_TERMS].offset);
+                terms[0].posting_begin = 1;
+                terms[0].posting_count = ~uint64_t{ 0 };
+            },
+            [](SnapshotHeader& header, char* payload) {
+                SnapshotDocument* documents = reinterpret_cast<SnapshotDocument*>(payload + header.sections[SNAPSHOT_DOCUMENTS].offset);
+                documents[0].forward_begin = 1;
+                documents[0].forward_count = ~uint64_t{ 0 };
+            },
+            [](SnapshotHeader& header, char* payload) {
+                SnapshotDocument* documents = reinterpret_cast<SnapshotDocument*>(payload + header.sections[SNAPSHOT_DOCUMENTS].offset);
+                documents[0].status = 7;
+            },
+        };
+        for (const auto& patch : broken) {
+            server.SaveSnapshot(path);
+            PatchSnapshot(path, patch);
+            try {
+                loaded.LoadSnapshot(path);
+                ASSERT_HINT(false, "Check LoadSnapshot()! Broken document or term hasn't been detected");
+            }
+            catch (const std::runtime_error&) {
+            }
+            ASSERT_EQUAL(loaded.GetDocumentCount(), 2);
+        }
+        std::remove(path.c_str());
+    }
+
+    void TestMappedSearchServer() {
+        const string path = "test_mapped_index.bin";
+        SearchServer server("and with"sv);
+        server.AddDocument(1, "funny pet and nasty rat"sv, DocumentStatus::ACTUAL, { 1, 2 });
+        server.AddDocument(2, "funny pet with curly hair"sv, DocumentStatus::ACTUAL, { 3, 4 });
+        server.AddDocument(3, "nasty rat with curly hair"sv, DocumentStatus::BANNED, { 5, 6 });
+        server.SaveSnapshot(path);
+        {
+            MappedSearchServer mapped(path, { MappedAccess::WILL_NEED, true, true });
+            ASSERT_EQUAL(mapped.GetDocumentCount(), 3);
+            const std::vector<Document> expected = server.FindTopDocuments("curly nasty -funny"sv, DocumentStatus::BANNED);
+            const std::vector<Document> res = mapped.FindTopDocuments("curly nasty -funny"sv, DocumentStatus::BANNED);
+            ASSERT_EQUAL(res.size(), 1u);
+            ASSERT_EQUAL(res[0].id, expected[0].id);
+            ASSERT(std::abs(res[0].relevance - expected[0].relevance) < 1e-6);
+            ASSERT_EQUAL(mapped.FindTopDocuments("pet and"sv).size(), 2u);
+
+            const auto [words, status] = mapped.MatchDocument("hair rat curly -dog"sv, 3);
+            ASSERT_EQUAL(words.size(), 3u);
+            ASSERT_EQUAL(words[0], "curly"sv);
+            ASSERT_EQUAL(status, DocumentStatus::BANNED);
+            ASSERT(std::get<0>(mapped.MatchDocument("hair -rat"sv, 3)).empty());
+        }
+
+        // ranges of a valid checksum running out of their sections are refused on open
+        const std::vector<std::function<void(SnapshotHeader&, char*)>> broken = {
+            [](SnapshotHeader& header, char* payload) {
+                SnapshotTerm* terms = reinterpret_cast<SnapshotTerm*>(payload + header.sections[SNAPSHOT_TERMS].offset);
+                terms[0].posting_count = header.sections[SNAPSHOT_POSTINGS].count + 1;
+            },
+            [](SnapshotHeader& header, char* payload) {
+                SnapshotDocument* documents = reinterpret_cast<SnapshotDocument*>(payload + header.sections[SNAPSHOT_DOCUMENTS].offset);
+                documents[2].forward_begin = ~uint64_t{ 0 };
+            },
+            [](SnapshotHeader& header, char* payload) {
+                SnapshotDocument* documents = reinterpret_cast<SnapshotDocument*>(payload + header.sections[SNAPSHOT_DOCUMENTS].offset);
+                documents[1].content.offset = header.sections[SNAPSHOT_STRINGS].count + 1;
+            },
+        };
+        for (const auto& patch : broken) {
+            server.SaveSnapshot(path);
+            PatchSnapshot(path, patch);
+            try {
+                MappedSearchServer mapped(path);
+                ASSERT_HINT(false, "Check MappedSearchServer! Range out of bounds hasn't been detected");
+            }
+            catch (const std::runtime_error&) {
+            }
+        }
+
+        // corrupt file without a checksum is refused by default
+        server.SaveSnapshot(path);
+        {
+            std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+            file.seekp(-1, std::ios::end);
+            file.put('\x7f');
+        }
+        try {
+            MappedSearchServer mapped(path);
+            ASSERT_HINT(false, "Check MappedSearchServer! Checksum isn't verified by default");
+        }
+        catch (const std::runtime_error&) {
+        }
+
+        // posting of an unknown document is skipped
+        server.SaveSnapshot(path);
+        PatchSnapshot(path, [](SnapshotHeader& header, char* payload) {
+            SnapshotPosting* postings = reinterpret_cast<SnapshotPosting*>(payload + header.sections[SNAPSHOT_POSTINGS].offset);
+            for (uint64_t i = 0; i < header.sections[SNAPSHOT_POSTINGS].count; ++i) {
+                if (postings[i].document_id == 2) {
+                    postings[i].document_id = 42;
+                }
+            }
+        });
+        {
+            MappedSearchServer mapped(path);
+            const std::vector<Document> res = mapped.FindTopDocuments("funny pet"sv);
+            ASSERT_EQUAL(res.size(), 1u);
+            ASSERT_EQUAL(res[0].id, 1);
+        }
+        std::remove(path.c_str());
+    }
+
+    void TestWriteAheadLogRecovery() {
+        const string log_path = "test_wal.log", checkpoint_path = "test_wal.checkpoint";
+        std::remove(log_path.c_str());
+        std::remove(checkpoint_path.c_str());
+        {
+            WalOptions options;
+            options.wait_durable = true;
+            options.checkpoint_bytes = 200;
+            WriteAheadLog wal(log_path, checkpoint_path, options);
+            SearchServer server("and with"sv);
+            server.AttachWriteAheadLog(&wal);
+            server.AddDocument(1, "funny pet and nasty rat"sv, DocumentStatus::ACTUAL, { 1, 2 });
+            server.AddDocument(2, "funny pet with curly hair"sv, DocumentStatus::ACTUAL, { 3, 4 });
+            server.AddDocuments(execution::par, { { 3, "nasty rat with curly hair"sv, DocumentStatus::BANNED, { 5 } },
+                                                  { 4, "big dog"sv, DocumentStatus::ACTUAL, {} } });
+            server.RemoveDocument(2);
+            server.AddDocument(5, "curly dog"sv, DocumentStatus::ACTUAL, { 7 });
+        }
+        {
+            WriteAheadLog wal(log_path, checkpoint_path);
+            SearchServer server("and with"sv);
+            ASSERT(wal.Recover(server) > 0u);
+            server.AttachWriteAheadLog(&wal);
+            ASSERT_EQUAL(server.GetDocumentCount(), 4);
+            ASSERT_EQUAL(server.FindTopDocuments("curly"sv).size(), 1u);
+            ASSERT_EQUAL(server.FindTopDocuments("curly"sv, DocumentStatus::BANNED).size(), 1u);
+            ASSERT_EQUAL(server.FindTopDocuments("dog"sv).size(), 2u);
+            server.RemoveDocuments({ 1 });
+        }
+        {
+            WriteAheadLog wal(log_path, checkpoint_path);
+            SearchServer server("and with"sv);
+            wal.Recover(server);
+            ASSERT_EQUAL(server.GetDocumentCount(), 3);
+            ASSERT(server.FindTopDocuments("funny"sv).empty());
+        }
+        std::remove(log_path.c_str());
+        std::remove(checkpoint_path.c_str());
+
+        // removals alone make a checkpoint due
+        {
+            WalOptions options;
+            options.wait_durable = true;
+            options.checkpoint_bytes = 200;
+            WriteAheadLog wal(log_path, checkpoint_path, options);
+            SearchServer server("and with"sv);
+            for (int id = 0; id < 40; ++id) {
+                server.AddDocument(id, "pet number"s + std::to_string(id), DocumentStatus::ACTUAL, { id });
+            }
+            server.AttachWriteAheadLog(&wal);
+            for (int id = 0; id < 30; ++id) {
+                if (id % 2 == 0) {
+                    server.RemoveDocument(execution::seq, id);
+                }
+                else {
+                    server.RemoveDocument(execution::par, id);
+                }
+            }
+            ASSERT(std::ifstream(checkpoint_path).good());
+        }
+        {
+            WriteAheadLog wal(log_path, checkpoint_path);
+            SearchServer server("and with"sv);
+            wal.Recover(server);
+            ASSERT_EQUAL(server.GetDocumentCount(), 10);
+        }
+        std::remove(log_path.c_str());
+        std::remove(checkpoint_path.c_str());
+    }
+
+    void TestIngestCorpus() {
+        const string path = "test_corpus.txt";
+        {
+            std::ofstream out(path, std::ios::binary);
+            out << "funny pet and nasty rat\n2 1 2\n"
+                << "funny pet with curly hair\r\n1 7\r\n"
+                << "bad \x12 symbol\n0\n"
+                << "corrupt ratings\n2147483647 1\n"
+                << "nasty rat with curly hair\n3 -1 -2 -3";
+        }
+        SearchServer server("and with"sv);
+        IngestionOptions options;
+        options.chunk_bytes = 8;
+        options.queue_capacity = 1;
+        options.tokenizer_threads = 2;
+        options.first_document_id = 10;
+        const IngestionStats stats = IngestCorpus(server, path, options);
+        std::remove(path.c_str());
+
+        ASSERT_EQUAL(stats.documents_indexed, 3u);
+        ASSERT_EQUAL(stats.documents_rejected, 2u);
+        ASSERT_EQUAL(server.GetDocumentCount(), 3);
+        const std::vector<Document> res = server.FindTopDocuments("curly"sv);
+        ASSERT_EQUAL(res.size(), 2u);
+        ASSERT_EQUAL(res[0].id, 11);
+        ASSERT_EQUAL(res[0].rating, 7);
+        ASSERT_EQUAL(res[1].id, 14);
+        ASSERT_EQUAL(res[1].rating, -2);
+        ASSERT_EQUAL(ParseRatings("3 4 5 6"sv).size(), 3u);
+        try {
+            ParseRatings("2147483647 1"sv);
+            ASSERT_HINT(false, "Check ParseRatings()! Oversized count hasn't been detected");
+        }
+        catch (const std::invalid_argument&) {
+        }
+
+        // documents rejected by duplicate detection are counted, every tokenized one is accounted for
+        {
+            std::ofstream out(path, std::ios::binary);
+            out << "funny pet and nasty rat\n1 1\n"
+                << "nasty rat and funny pet\n1 2\n"
+                << "curly hair\n1 3\n"
+                << "funny pet with nasty rat\n1 4\n";
+        }
+        SearchServer rejecting("and with"sv);
+        rejecting.EnableDuplicateDetection(SearchServer::DuplicateAction::REJECT);
+        const IngestionStats rejected_stats = IngestCorpus(rejecting, path, options);
+        std::remove(path.c_str());
+        ASSERT_EQUAL(rejected_stats.documents_tokenized, 4u);
+        ASSERT_EQUAL(rejected_stats.documents_indexed, 2u);
+        ASSERT_EQUAL(rejected_stats.documents_rejected, 2u);
+        ASSERT_EQUAL(rejecting.GetDocumentCount(), 2);
+    }
+
+    void TestWordScanner() {
+        string text;
+        std::vector<string> expected;
+        for (int i = 0; i < 40; ++i) {
+            expected.push_back(string(i % 7 + 1, static_cast<char>('a' + i % 26)) + "\xD0\xB9");
+            text += string(i % 3 + 1, ' ') + expected.back();
+        }
+        text += "  ";
+        {
+            const std::vector<std::string_view> res = SplitIntoWords(text);
+            ASSERT_EQUAL(res.size(), expected.size());
+            for (size_t i = 0; i < res.size(); ++i) {
+                ASSERT_EQUAL(res[i], expected[i]);
+            }
+        }
+        {
+            const string exact(64, 'x');
+            ASSERT_EQUAL(SplitIntoWords(exact).size(), 1u);
+            ASSERT_EQUAL(SplitIntoWords(exact)[0], exact);
+            ASSERT(SplitIntoWords(string(130, ' ')).empty());
+        }
+        {
+            const string broken = text + " bad\x1Fword tail";
+            WordScanner scanner(broken);
+            std::string_view word;
+            size_t count = 0;
+            while (scanner.Next(word)) {
+                ++count;
+            }
+            ASSERT(!scanner.Valid());
+            ASSERT(count <= expected.size());
+            ASSERT(HasSpecialSymbols(text + "\t"));
+            ASSERT(!HasSpecialSymbols(text));
+        }
+    }
+
+    void TestSplitIntoWordsLazy() {
+        const string text = "  white cat  and fancy collar ";
+        std::vector<std::string_view> res;
+        for (const std::string_view word : SplitIntoWordsLazy(text)) {
+            res.push_back(word);
+        }
+        ASSERT(res == SplitIntoWords(text));
+
+        const WordRange words = SplitIntoWordsLazy(text);
+        ASSERT_EQUAL(std::distance(words.begin(), words.end()), 5);
+        ASSERT_EQUAL(*std::find(words.begin(), words.end(), "fancy"sv), "fancy"sv);
+        ASSERT(SplitIntoWordsLazy("   ").begin() == WordRange::Iterator());
+
+        try {
+            for (const std::string_view word : SplitIntoWordsLazy("cat bad\x12word", "bad text")) {
+                ASSERT_EQUAL(word, "cat"sv);
+            }
+            ASSERT_HINT(false, "No exception for special symbol");
+        }
+        catch (const std::invalid_argument& e) {
+            ASSERT_EQUAL(string(e.what()), "bad text"s);
+        }
+    }
+
+    void TestCaseFoldingAndPunctuation() {
+        {
+            std::vector<char> buffer;
+            const string text = "lower case ascii text goes first, Then Upper \xD0\x9A\xD0\x9E\xD0\xA2 \xC3\x89t\xC3\xA9";
+            ASSERT_EQUAL(FoldCase(text, buffer), "lower case ascii text goes first, then upper \xD0\xBA\xD0\xBE\xD1\x82 \xC3\xA9t\xC3\xA9"sv);
+            const string lower = "already lower \xD0\xBA\xD0\xBE\xD1\x82 \xEA\xEE\xF2";
+            ASSERT_EQUAL(FoldCase(lower, buffer).data(), lower.data());
+            ASSERT_EQUAL(TrimPunctuation("\"(rat),\""sv), "rat"sv);
+            ASSERT_EQUAL(TrimPunctuation("\xC2\xABwell-known\xE2\x80\xA6\xC2\xBB"sv), "well-known"sv);
+            ASSERT(TrimPunctuation("--"sv).empty());
+        }
+        {
+            SearchServer server("The"s);
+            server.AddDocument(1, "Rat, the CAT"sv, DocumentStatus::ACTUAL, { 1 });
+            server.AddDocument(2, "\"rat\" and dog"sv, DocumentStatus::ACTUAL, { 1 });
+            server.AddDocument(3, "\xD0\x9A\xD0\x9E\xD0\xA2 \xE2\x80\x94 ..."sv, DocumentStatus::ACTUAL, { 1 });
+            ASSERT_EQUAL(server.GetWordFrequencies(1).size(), 2u);
+            ASSERT_EQUAL(server.FindTopDocuments("RAT"sv).size(), 2u);
+            ASSERT_EQUAL(server.FindTopDocuments("rat -Cat,"sv).size(), 1u);
+            ASSERT(server.FindTopDocuments("the"sv).empty());
+            ASSERT_EQUAL(server.FindTopDocuments("\xD0\xBA\xD0\xBE\xD1\x82!"sv).size(), 1u);
+            ASSERT_EQUAL(server.GetWordFrequencies(3).size(), 1u);
+
+            const auto [words, status] = server.MatchDocument("CAT Rat dog"sv, 1);
+            ASSERT_EQUAL(words.size(), 2u);
+            ASSERT_EQUAL(words[0], "cat"sv);
+            ASSERT_EQUAL(words[1], "rat"sv);
+        }
+    }
+
+    void TestPreparedQuery() {
+        SearchServer server("and"s);
+        server.AddDocument(1, "fluffy cat and collar"sv, DocumentStatus::ACTUAL, { 5 });
+        server.AddDocument(2, "fluffy dog"sv, DocumentStatus::ACTUAL, { 3 });
+        server.AddDocument(3, "lonely cat"sv, DocumentStatus::BANNED, { 1 });
+
+        auto same = [](const std::vector<Document>& lhs, const std::vector<Document>& rhs) {
+            return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin(),
+                [](const Document& l, const Document& r) { return l.id == r.id && std::abs(l.relevance - r.relevance) < 1e-9; });
+        };
+
+        std::optional<SearchServer::PreparedQuery> prepared;
+        {
+            const string raw_query = "Fluffy cat -dog"s;
+            prepared.emplace(server.Prepare(raw_query));
+            ASSERT(same(server.FindTopDocuments(*prepared), server.FindTopDocuments(raw_query)));
+        }
+        ASSERT_EQUAL(prepared->GetRawQuery(), "Fluffy cat -dog"sv);
+        ASSERT_EQUAL(prepared->GetGeneration(), server.GetGeneration());
+        ASSERT_EQUAL(server.FindTopDocuments(*prepared, DocumentStatus::BANNED).size(), 1u);
+        ASSERT_EQUAL(server.FindTopDocuments(execution::par, *prepared).size(), 1u);
+        ASSERT_EQUAL(std::get<0>(server.MatchDocument(*prepared, 1)).size(), 2u);
+        ASSERT(std::get<0>(server.MatchDocument(*prepared, 2)).empty());
+
+        // stale query is resolved again, postings it pointed to may be gone
+        server.AddDocument(4, "cat"sv, DocumentStatus::ACTUAL, { 2 });
+        server.RemoveDocument(3);
+        server.RemoveDocument(1);
+        ASSERT(prepared->GetGeneration() != server.GetGeneration());
+        ASSERT(same(server.FindTopDocuments(*prepared), server.FindTopDocuments("fluffy cat -dog"sv)));
+        ASSERT_EQUAL(server.FindTopDocuments(*prepared)[0].id, 4);
+        ASSERT_EQUAL(std::get<0>(server.MatchDocument(*prepared, 4)).size(), 1u);
+        // resolved again once, later runs of the generation reuse it
+        ASSERT_EQUAL(prepared->GetGeneration(), server.GetGeneration());
+
+        // stale query run from many threads at once
+        server.AddDocument(5, "fluffy cat"sv, DocumentStatus::ACTUAL, { 4 });
+        const std::vector<Document> expected = server.FindTopDocuments("fluffy cat -dog"sv);
+        std::vector<std::thread> threads;
+        std::atomic<int> mismatches{ 0 };
+        for (int i = 0; i < 4; ++i) {
+            threads.emplace_back([&] {
+                for (int j = 0; j < 100; ++j) {
+                    if (!same(server.FindTopDocuments(*prepared), expected)) {
+                        ++mismatches;
+                    }
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        ASSERT_EQUAL(mismatches.load(), 0);
+        ASSERT_EQUAL(prepared->GetGeneration(), server.GetGeneration());
+    }
+
+    void TestResultCache() {
+        SearchServer server(""s);
+        server.AddDocument(1, "white cat"sv, DocumentStatus::ACTUAL, { 1 });
+        server.AddDocument(2, "black dog"sv, DocumentStatus::ACTUAL, { 2 });
+        server.EnableResultCache(1 << 20, 4);
+
+        ASSERT_EQUAL(server.FindTopDocuments("cat dog"sv).size(), 2u);
+        ASSERT_EQUAL(server.FindTopDocuments("Dog  cat, dog"sv).size(), 2u);
+        ASSERT_EQUAL(server.FindTopDocuments("cat dog"sv, DocumentStatus::BANNED).size(), 0u);
+        ResultCacheStats stats = server.GetResultCacheStats();
+        ASSERT_EQUAL(stats.hits, 1u);
+        ASSERT_EQUAL(stats.misses, 2u);
+        ASSERT_EQUAL(stats.entries, 2u);
+        ASSERT(stats.bytes > 0);
+
+        // new document makes the entry stale
+        server.AddDocument(3, "cat"sv, DocumentStatus::ACTUAL, { 3 });
+        ASSERT_EQUAL(server.FindTopDocuments(server.Prepare("cat dog"sv)).size(), 3u);
+        stats = server.GetResultCacheStats();
+        ASSERT_EQUAL(stats.stale, 1u);
+        ASSERT_EQUAL(stats.hits, 1u);
+        ASSERT_EQUAL(server.FindTopDocuments("cat dog"sv).size(), 3u);
+        ASSERT_EQUAL(server.GetResultCacheStats().hits, 2u);
+
+        // one shard holding about one entry
+        server.EnableResultCache(200, 1);
+        server.FindTopDocuments("cat"sv);
+        server.FindTopDocuments("dog"sv);
+        stats = server.GetResultCacheStats();
+        ASSERT_EQUAL(stats.entries, 1u);
+        ASSERT_EQUAL(stats.evictions, 1u);
+        ASSERT(stats.bytes <= 200);
+        ASSERT(stats.HitRatio() == 0.0);
+    }
+
+    void TestQueryArena() {
+        SearchServer server("and"s);
+        for (int id = 0; id < 50; ++id) {
+            server.AddDocument(id, "cat and dog number"s + std::to_string(id), DocumentStatus::ACTUAL, { id });
+        }
+
+        ResetQueryArenaStats();
+        for (int i = 0; i < 10; ++i) {
+            ASSERT_EQUAL(server.FindTopDocuments("cat -number7"sv).size(), 5u);
+        }
+        ASSERT_EQUAL(std::get<0>(server.MatchDocument("Dog cat"sv, 3)).size(), 2u);
+        QueryArenaStats stats = GetQueryArenaStats();
+        ASSERT_EQUAL(stats.queries, 11u);
+        ASSERT(stats.allocations >= 11 * 2);
+        ASSERT(stats.AllocationsPerQuery() > 0.0);
+        // arena buffer grows after the first overflow, repeated queries stay in it
+        ResetQueryArenaStats();
+        for (int i = 0; i < 10; ++i) {
+            server.FindTopDocuments("cat dog"sv);
+        }
+        stats = GetQueryArenaStats();
+        ASSERT_EQUAL(stats.upstream_allocations, 0u);
+
+        // nested scopes release once, memory of the outer one is still usable
+        {
+            QueryArenaScope outer;
+            std::pmr::vector<int> numbers({ 1, 2, 3 }, outer.Resource());
+            server.FindTopDocuments("cat"sv);
+            ASSERT_EQUAL(numbers[2], 3);
+        }
+    }
+
+    // counts memory in use, so a leak or a foreign deallocation shows up
+    class TestResource : public std::pmr::memory_resource {
+    public:
+        size_t bytes_in_use = 0;
+        size_t allocations = 0;
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            bytes_in_use += bytes;
+            ++allocations;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+        void do_deallocate(void* pointer, size_t bytes, size_t alignment) override {
+            bytes_in_use -= bytes;
+            std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+        }
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    };
+
+    void TestIndexMemoryResource() {
+        TestResource resource;
+        {
+            SearchServer server("and in"s, &resource);
+            ASSERT_EQUAL(server.GetMemoryResource(), static_cast<std::pmr::memory_resource*>(&resource));
+
+            // index containers must not fall back to the default resource
+            std::pmr::memory_resource* default_resource = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+            try {
+                server.AddDocument(1, "fluffy cat in a long long collar"sv, DocumentStatus::ACTUAL, { 1 });
+                server.AddDocument(2, "Dog and cat"sv, DocumentStatus::ACTUAL, { 2 });
+                server.RemoveDocuments({ 2 });
+                server.CompactRemovedDocuments(execution::seq);
+                server.AddDocument(3, "cat"sv, DocumentStatus::ACTUAL, { 3 });
+            }
+            catch (const std::bad_alloc&) {
+                ASSERT_HINT(false, "index allocated from the default resource");
+            }
+            std::pmr::set_default_resource(default_resource);
+
+            ASSERT(resource.bytes_in_use > 0);
+            ASSERT_EQUAL(server.FindTopDocuments("cat"sv).size(), 2u);
+
+            const string path = "test_index_resource.snapshot"s;
+            server.SaveSnapshot(path);
+            SearchServer loaded(""s, &resource);
+            loaded.LoadSnapshot(path);
+            std::remove(path.c_str());
+            ASSERT_EQUAL(loaded.FindTopDocuments("collar"sv).size(), 1u);
+        }
+        ASSERT_EQUAL(resource.bytes_in_use, 0u);
+
+        // index on a pool behaves the same
+        std::pmr::unsynchronized_pool_resource pool;
+        SearchServer pooled(""s, &pool);
+        pooled.AddDocument(1, "cat"sv, DocumentStatus::ACTUAL, { 1 });
+        ASSERT_EQUAL(pooled.FindTopDocuments("cat"sv).size(), 1u);
+    }
+
+    void TestMatchDocuments() {
+        SearchServer server("and"s);
+        server.AddDocument(1, "white cat and collar"sv, DocumentStatus::ACTUAL, { 1 });
+        server.AddDocument(2, "black dog"sv, DocumentStatus::BANNED, { 2 });
+        server.AddDocument(3, "cat with dog"sv, DocumentStatus::ACTUAL, { 3 });
+        server.AddDocument(4, "white collar"sv, DocumentStatus::IRRELEVANT, { 4 });
+
+        const string raw_query = "cat collar white -black"s;
+        const std::vector<int> ids = { 4, 1, 2, 3 };
+        // minus words outnumbering plus words must not spill into the next document's slot
+        const std::vector<std::pair<string, size_t>> queries = {
+            { raw_query, 6 }, { "cat -white -collar -black -with"s, 0 }, { "dog -white -collar -black"s, 1 }, { "-cat -dog -white"s, 0 } };
+        for (const auto& [query, total] : queries) {
+            for (const bool parallel : { true, false }) {
+                const SearchServer::MatchedDocuments matched = parallel
+                    ? server.MatchDocuments(query, ids)
+                    : server.MatchDocuments(execution::seq, query, ids);
+                ASSERT_EQUAL(matched.Size(), ids.size());
+                ASSERT_EQUAL(matched.words.size(), total);
+                for (size_t i = 0; i < ids.size(); ++i) {
+                    const auto [words, status] = server.MatchDocument(query, ids[i]);
+                    ASSERT(status == matched.statuses[i]);
+                    ASSERT_EQUAL(matched.Words(i).size(), words.size());
+                    ASSERT(std::equal(words.begin(), words.end(), matched.Words(i).begin(), matched.Words(i).end()));
+                }
+            }
+        }
+
+        server.RemoveDocuments({ 3 });
+        try {
+            server.MatchDocuments(raw_query, ids);
+            ASSERT_HINT(false, "No exception for removed document");
+        }
+        catch (const std::out_of_range&) {
+        }
+        ASSERT(server.MatchDocuments(raw_query, {}).words.empty());
+    }
+
+    void TestTermIntersection() {
+        // skewed sizes gallop, similar sizes go by blocks, both against a plain set intersection
+        for (const auto& [lhs_size, rhs_size, lhs_step, rhs_step] : std::vector<std::tuple<uint32_t, uint32_t, uint32_t, uint32_t>>{
+                { 3, 1000, 7, 2 }, { 1000, 3, 2, 7 }, { 100, 100, 3, 2 }, { 37, 53, 5, 3 }, { 9, 7, 1, 1 } }) {
+            std::vector<uint32_t> lhs, rhs;
+            for (uint32_t i = 0; i < lhs_size; ++i) {
+                lhs.push_back(i * lhs_step + 1);
+            }
+            for (uint32_t i = 0; i < rhs_size; ++i) {
+                rhs.push_back(i * rhs_step);
+            }
+            std::vector<uint32_t> positions(lhs.size());
+            positions.resize(IntersectSorted(lhs.data(), lhs.size(), rhs.data(), rhs.size(), positions.data()));
+            std::vector<uint32_t> expected;
+            for (uint32_t i = 0; i < lhs.size(); ++i) {
+                if (std::binary_search(rhs.begin(), rhs.end(), lhs[i])) {
+                    expected.push_back(i);
+                }
+            }
+            ASSERT(positions == expected);
+            ASSERT_EQUAL(IntersectsSorted(lhs.data(), lhs.size(), rhs.data(), rhs.size()), !expected.empty());
+            ASSERT_EQUAL(IntersectsSorted(rhs.data(), rhs.size(), lhs.data(), lhs.size()), !expected.empty());
+        }
+
+        // minus words are checked without scratch, queries of minus words only never match
+        {
+            SearchServer server(""s);
+            server.AddDocument(1, "cat"sv, DocumentStatus::ACTUAL, { 1 });
+            server.AddDocument(2, "dog bird fish cow"sv, DocumentStatus::ACTUAL, { 1 });
+            ASSERT(std::get<0>(server.MatchDocument("-cat -dog -bird -fish"s, 1)).empty());
+            ASSERT(std::get<0>(server.MatchDocument("-cat -dog -bird -fish"s, 2)).empty());
+            ASSERT(std::get<0>(server.MatchDocument(execution::par, "-cat -dog -bird -fish"s, 2)).empty());
+            ASSERT(std::get<0>(server.MatchDocument("cow -cat -dog -bird -fish"s, 2)).empty());
+            ASSERT(std::get<0>(server.MatchDocument("cow -cat -bird -fish"s, 2)).empty());
+            ASSERT(std::get<0>(server.MatchDocument("cow -cat -ant -eel -fox"s, 2)) == std::vector<std::string_view>({ "cow"sv }));
+        }
+
+        // term ids follow first appearance, matched words still come in word order
+        SearchServer server("and"s);
+        server.AddDocument(1, "zebra yak and xerus"sv, DocumentStatus::ACTUAL, { 1 });
+        server.AddDocument(2, "yak ant zebra"sv, DocumentStatus::BANNED, { 2 });
+        server.AddDocument(3, "xerus bee"sv, DocumentStatus::ACTUAL, { 3 });
+        const std::vector<std::string_view> expected = { "ant"sv, "yak"sv, "zebra"sv };
+        {
+            const auto [words, status] = server.MatchDocument("zebra ant yak xerus -bee"s, 2);
+            ASSERT(words == expected);
+            ASSERT(status == DocumentStatus::BANNED);
+            const auto [par_words, par_status] = server.MatchDocument(execution::par, "zebra ant yak -bee"s, 2);
+            ASSERT(par_words == expected);
+            ASSERT(std::get<0>(server.MatchDocument("xerus -bee"s, 3)).empty());
+        }
+
+        // ids of dropped words are not reused, snapshot renumbers them
+        server.RemoveDocument(3);
+        server.AddDocument(4, "bee cow ant"sv, DocumentStatus::ACTUAL, { 4 });
+        const SearchServer::PreparedQuery query = server.Prepare("ant bee cow xerus -zebra"s);
+        ASSERT(std::get<0>(server.MatchDocument(query, 4)) == std::vector<std::string_view>({ "ant"sv, "bee"sv, "cow"sv }));
+        ASSERT(std::get<0>(server.MatchDocument(query, 2)).empty());
+
+        const string path = "test_term_ids.snapshot"s;
+        server.SaveSnapshot(path);
+        SearchServer loaded(""s);
+        loaded.LoadSnapshot(path);
+        std::remove(path.c_str());
+        loaded.AddDocument(5, "ant dog"sv, DocumentStatus::ACTUAL, { 5 });
+        ASSERT(std::get<0>(loaded.MatchDocument("cow ant bee xerus"s, 4)) == std::vector<std::string_view>({ "ant"sv, "bee"sv, "cow"sv }));
+        ASSERT(std::get<0>(loaded.MatchDocument("dog ant -cow"s, 5)) == std::vector<std::string_view>({ "ant"sv, "dog"sv }));
+        ASSERT(std::get<0>(loaded.MatchDocument("dog ant -cow"s, 4)).empty());
+    }
+
+    void TestMatchDocumentPositions() {
+        SearchServer server("and"s);
+        server.AddDocument(1, "white cat and collar"sv, DocumentStatus::ACTUAL, { 1 });
+        server.AddDocument(2, "black dog"sv, DocumentStatus::BANNED, { 2 });
+        server.AddDocument(3, "cat with dog"sv, DocumentStatus::IRRELEVANT, { 3 });
+
+        // positions index the sorted plus words, unknown words keep their slots
+        const SearchServer::PreparedQuery query = server.Prepare("white parrot cat dog -black"s);
+        const auto& plus_words = query.GetPlusWords();
+        ASSERT(plus_words == std::pmr::vector<std::string_view>({ "cat"sv, "dog"sv, "parrot"sv, "white"sv }));
+        std::vector<uint32_t> positions(plus_words.size());
+        for (const int document_id : { 1, 2, 3 }) {
+            const auto [count, status] = server.MatchDocument(query, document_id, positions.data());
+            const auto [words, expected_status] = server.MatchDocument(query, document_id);
+            ASSERT_EQUAL(count, words.size());
+            ASSERT(status == expected_status);
+            for (size_t i = 0; i < count; ++i) {
+                ASSERT_EQUAL(plus_words[positions[i]], words[i]);
+            }
+        }
+        ASSERT_EQUAL(std::get<0>(server.MatchDocument(query, 3, positions.data())), 2u);
+        ASSERT_EQUAL(positions[0], 0u);
+        ASSERT_EQUAL(positions[1], 1u);
+
+        // stale query is resolved again, slots stay the same
+        server.AddDocument(4, "parrot and white dog"sv, DocumentStatus::ACTUAL, { 4 });
+        const auto [count, status] = server.MatchDocument(query, 4, positions.data());
+        ASSERT_EQUAL(count, 3u);
+        ASSERT(std::vector<uint32_t>(positions.begin(), positions.begin() + count) == std::vector<uint32_t>({ 1, 2, 3 }));
+        ASSERT(status == DocumentStatus::ACTUAL);
+
+        // buffer of exactly GetPlusWords().size(), minus words outnumber plus words and are in the documents
+        const std::vector<std::pair<string, std::vector<size_t>>> minus_heavy_queries = {
+            { "cat -white -collar -black -parrot -eel"s, { 0, 0, 1, 0 } },
+            { "-white -collar -dog -cat"s, { 0, 0, 0, 0 } },
+        };
+        for (const auto& [raw_query, expected_counts] : minus_heavy_queries) {
+            const SearchServer::PreparedQuery minus_heavy = server.Prepare(raw_query);
+            std::vector<uint32_t> exact(minus_heavy.GetPlusWords().size());
+            for (const int document_id : { 1, 2, 3, 4 }) {
+                ASSERT_EQUAL(std::get<0>(server.MatchDocument(minus_heavy, document_id, exact.data())), expected_counts[document_id - 1]);
+            }
+        }
+    }
+
+    void TestProcessQueriesStreaming() {
+        SearchServer server("and with"s);
+        const std::vector<string> words = { "funny"s, "pet"s, "nasty"s, "rat"s, "curly"s, "hair"s, "big"s, "dog"s };
+        for (int id = 0; id < 200; ++id) {
+            server.AddDocument(id, words[id % words.size()] + " "s + words[id * 7 % words.size()] + " and "s + words[id * 3 % words.size()],
+                DocumentStatus::ACTUAL, { id % 10 });
+        }
+        std::vector<string> queries;
+        for (size_t i = 0; i < 100; ++i) {
+            queries.push_back(words[i % words.size()] + " "s + words[i * 5 % words.size()] + " -"s + words[i * 3 % words.size()]);
+        }
+
+        // every query reported once with the same result as a plain call
+        for (const size_t thread_count : { 1u, 3u, 16u }) {
+            std::mutex mutex;
+            std::vector<int> reported(queries.size());
+            ProcessQueriesStreaming(server, queries,
+                [&](size_t index, std::vector<Document> documents) {
+                    const std::vector<Document> expected = server.FindTopDocuments(queries[index]);
+                    std::lock_guard lock(mutex);
+                    ++reported[index];
+                    ASSERT_EQUAL(documents.size(), expected.size());
+                    for (size_t i = 0; i < expected.size(); ++i) {
+                        ASSERT_EQUAL(documents[i].id, expected[i].id);
+                    }
+                },
+                thread_count);
+            ASSERT(std::all_of(reported.begin(), reported.end(), [](int count) { return count == 1; }));
+        }
+        ASSERT_EQUAL(ProcessQueries(server, queries).size(), queries.size());
+        ProcessQueriesStreaming(server, {}, [](size_t, std::vector<Document>) { ASSERT(false); });
+
+        queries[42] = "rat -"s;
+        try {
+            ProcessQueries(server, queries);
+            ASSERT_HINT(false, "No exception for invalid query");
+        }
+        catch (const std::invalid_argument&) {
+        }
+    }
+
+    void TestProcessQueriesFlat() {
+        SearchServer server("and with"s);
+        const std::vector<string> words = { "funny"s, "pet"s, "nasty"s, "rat"s, "curly"s, "hair"s, "big"s, "dog"s };
+        for (int id = 0; id < 50; ++id) {
+            server.AddDocument(id, words[id % words.size()] + " "s + words[id * 3 % words.size()], DocumentStatus::ACTUAL, { id % 10 });
+        }
+        const std::vector<string> queries = { "funny pet"s, "parrot"s, "rat -hair"s, "big dog curly"s, "nasty"s };
+
+        // i-th range holds exactly the i-th result, joined documents are the same buffer
+        const std::vector<std::vector<Document>> nested = ProcessQueries(server, queries);
+        const QueryBatchResults flat = ProcessQueriesFlat(server, queries);
+        ASSERT_EQUAL(flat.Size(), queries.size());
+        for (size_t i = 0; i < queries.size(); ++i) {
+            ASSERT(std::equal(nested[i].begin(), nested[i].end(), flat.Documents(i).begin(), flat.Documents(i).end(),
+                [](const Document& lhs, const Document& rhs) { return lhs.id == rhs.id && lhs.rating == rhs.rating; }));
+        }
+        ASSERT(flat.Documents(1).begin() == flat.Documents(1).end());
+        ASSERT_EQUAL(flat.offsets.back(), flat.documents.size());
+        ASSERT_EQUAL(ProcessQueriesJoined(server, queries).size(), flat.documents.size());
+        ASSERT_EQUAL(ProcessQueriesFlat(server, {}).Size(), 0u);
+    }
+
+    void TestAsyncQueries() {
+        SearchServer server("and with"s);
+        server.AddDocument(1, "funny pet and nasty rat"sv, DocumentStatus::ACTUAL, { 7, 2, 7 });
+        server.AddDocument(2, "funny pet with curly hair"sv, DocumentStatus::ACTUAL, { 1, 2 });
+        server.AddDocument(3, "big cat nasty hair"sv, DocumentStatus::BANNED, { 1, 2, 8 });
+        try {
+            server.FindTopDocumentsAsync("pet"sv);
+            ASSERT_HINT(false, "No exception while async queries are disabled");
+        }
+        catch (const std::runtime_error&) {
+        }
+
+        server.EnableAsyncQueries(2, 4);
+        const std::vector<string> queries = { "funny pet"s, "nasty -rat"s, "curly hair"s, "parrot"s, "big cat"s };
+        std::vector<std::future<std::vector<Document>>> results;
+        for (const string& query : queries) {
+            results.push_back(server.FindTopDocumentsAsync(query));
+        }
+        for (size_t i = 0; i < queries.size(); ++i) {
+            const std::vector<Document> documents = results[i].get();
+            const std::vector<Document> expected = server.FindTopDocuments(queries[i]);
+            ASSERT_EQUAL(documents.size(), expected.size());
+            for (size_t j = 0; j < expected.size(); ++j) {
+                ASSERT_EQUAL(documents[j].id, expected[j].id);
+            }
+        }
+        ASSERT_EQUAL(server.FindTopDocumentsAsync("big cat"sv, DocumentStatus::BANNED).get().size(), 1u);
+        try {
+            server.FindTopDocumentsAsync("rat -"sv).get();
+            ASSERT_HINT(false, "No exception for invalid query");
+        }
+        catch (const std::invalid_argument&) {
+        }
+
+        // one busy thread and a queue of one: the third submission is refused without blocking
+        server.EnableAsyncQueries(1, 1);
+        std::promise<void> started, release;
+        std::shared_future<void> released = release.get_future().share();
+        std::promise<size_t> second;
+        ASSERT(server.TryFindTopDocumentsAsync("pet"sv, DocumentStatus::ACTUAL,
+            [&started, released](std::vector<Document>, std::exception_ptr) { started.set_value(); released.wait(); }));
+        started.get_future().wait();
+        ASSERT(server.TryFindTopDocumentsAsync("pet"sv, DocumentStatus::ACTUAL,
+            [&second](std::vector<Document> documents, std::exception_ptr error) { second.set_value(error ? 0 : documents.size()); }));
+        ASSERT(!server.TryFindTopDocumentsAsync("pet"sv, DocumentStatus::ACTUAL, [](std::vector<Document>, std::exception_ptr) { ASSERT(false); }));
+        release.set_value();
+        ASSERT_EQUAL(second.get_future().get(), 2u);
+
+        // throwing callback leaves the pool thread serving
+        ASSERT(server.TryFindTopDocumentsAsync("pet"sv, DocumentStatus::ACTUAL,
+            [](std::vector<Document>, std::exception_ptr) { throw std::runtime_error("callback failed"); }));
+        ASSERT_EQUAL(server.FindTopDocumentsAsync("pet"sv).get().size(), 2u);
+        server.DisableAsyncQueries();
+    }
+
+    // HINT : runs in the caller, counts ParallelFor calls
+    class CountingExecutor : public Executor {
+    public:
+        void ParallelFor(size_t count, const std::function<void(size_t)>& body) override {
+            ++calls;
+            sequential_.ParallelFor(count, body);
+        }
+
+        size_t GetConcurrency() const override {
+            return 1;
+        }
+
+        int calls = 0;
+
+    private:
+        SequentialExecutor sequential_;
+    };
+
+    void TestExecutor() {
+        // every index once, first exception comes out, nested calls don't deadlock a busy pool
+        ThreadPoolExecutor pool(ExecutorOptions{ 2, {}, 4 });
+        ASSERT_EQUAL(pool.GetConcurrency(), 3u);
+        std::vector<std::atomic<int>> visits(1000);
+        pool.ParallelFor(visits.size(), [&](size_t i) {
+            pool.ParallelFor(3, [&](size_t) {});
+            ++visits[i];
+        });
+        ASSERT(std::all_of(visits.begin(), visits.end(), [](const std::atomic<int>& count) { return count == 1; }));
+        try {
+            pool.ParallelFor(100, [](size_t i) {
+                if (i == 42) {
+                    throw std::out_of_range("42");
+                }
+            });
+            ASSERT_HINT(false, "No exception from ParallelFor");
+        }
+        catch (const std::out_of_range&) {
+        }
+        try {
+            ThreadPoolExecutor broken(ExecutorOptions{ 1, { -1 }, 1 });
+            ASSERT_HINT(false, "No exception for invalid CPU");
+        }
+        catch (const std::runtime_error&) {
+        }
+#ifdef __linux__
+        cpu_set_t allowed;
+        ASSERT(sched_getaffinity(0, sizeof(allowed), &allowed) == 0);
+        int cpu = 0;
+        while (!CPU_ISSET(cpu, &allowed)) {
+            ++cpu;
+        }
+        ThreadPoolExecutor pinned(ExecutorOptions{ 2, { cpu }, 4 });
+        std::atomic<int> sum = 0;
+        pinned.ParallelFor(10, [&](size_t i) { sum += static_cast<int>(i); });
+        ASSERT_EQUAL(sum.load(), 45);
+#endif
+
+        // every par overload goes through the server's executor
+        SearchServer server("and with"s);
+        CountingExecutor executor;
+        server.SetExecutor(&executor);
+        ASSERT(&server.GetExecutor() == &executor);
+        server.AddDocuments(execution::par, {
+            { 1, "funny pet and nasty rat"sv, DocumentStatus::ACTUAL, { 7, 2, 7 } },
+            { 2, "funny pet with curly hair"sv, DocumentStatus::ACTUAL, { 1, 2 } },
+            { 3, "big cat nasty hair"sv, DocumentStatus::ACTUAL, { 1, 2, 8 } },
+        });
+        ASSERT_EQUAL(executor.calls, 1);
+        ASSERT_EQUAL(server.FindTopDocuments(execution::par, "nasty pet"sv).size(), 3u);
+        ASSERT_EQUAL(server.MatchDocuments(execution::par, "nasty pet"s, { 1, 2 }).words.size(), 3u);
+        ASSERT_EQUAL(ProcessQueries(server, { "funny"s, "hair"s }).size(), 2u);
+        server.RemoveDocument(execution::par, 1);
+        server.RemoveDocuments({ 2 });
+        server.CompactRemovedDocuments(execution::par);
+        ASSERT_EQUAL(executor.calls, 6);
+        server.FindTopDocuments(execution::seq, "nasty pet"sv);
+        ASSERT_EQUAL(executor.calls, 6);
+        server.SetExecutor(nullptr);
+        ASSERT(&server.GetExecutor() == &DefaultExecutor());
+    }
+
+    void TestProcessQueriesShared() {
+        SearchServer server("and with"s);
+        const std::vector<string> words = { "funny"s, "pet"s, "nasty"s, "rat"s, "curly"s, "hair"s, "big"s, "dog"s, "cat"s };
+        for (int id = 0; id < 300; ++id) {
+            server.AddDocument(id, words[id % words.size()] + " "s + words[id * 7 % words.size()] + " and "s + words[id * 5 % words.size()],
+                static_cast<DocumentStatus>(id % 7 == 0 ? 1 : 0), { id % 10, id % 3 });
+        }
+        server.RemoveDocuments({ 4, 5, 6 });
+
+        // more unique queries than one chunk, repeats in other word order, unknown words
+        std::vector<string> queries;
+        for (size_t i = 0; i < 1500; ++i) {
+            queries.push_back(words[i % words.size()] + " "s + words[i * 5 % words.size()] + " -"s + words[i * 2 % words.size()] + " w"s + std::to_string(i % 1100));
+        }
+        queries.push_back("pet funny"s);
+        queries.push_back("funny pet"s);
+        queries.push_back("parrot"s);
+
+        const QueryBatchResults expected = ProcessQueriesFlat(server, queries);
+        const QueryBatchResults shared = ProcessQueriesShared(server, queries);
+        ASSERT(expected.offsets == shared.offsets);
+        for (size_t i = 0; i < expected.documents.size(); ++i) {
+            ASSERT_EQUAL(shared.documents[i].id, expected.documents[i].id);
+            ASSERT_EQUAL(shared.documents[i].relevance, expected.documents[i].relevance);
+            ASSERT_EQUAL(shared.documents[i].rating, expected.documents[i].rating);
+        }
+
+        std::atomic<int> irrelevant = 0;
+        server.FindTopDocumentsShared({ "cat dog"s, "dog cat"s }, DocumentStatus::IRRELEVANT,
+            [&](size_t, const std::vector<Document>& documents) { irrelevant += static_cast<int>(documents.size()); });
+        ASSERT_EQUAL(irrelevant.load(), 10);
+
+        queries.push_back("rat --dog"s);
+        try {
+            ProcessQueriesShared(server, queries);
+            ASSERT_HINT(false, "No exception for invalid query");
+        }
+        catch (const std::invalid_argument&) {
+        }
+    }
+
+    void TestRemoveDuplicates() {
+        SearchServer server("and with"s);
+        server.AddDocument(1, "funny pet and nasty rat"sv, DocumentStatus::ACTUAL, { 7, 2, 7 });
+        server.AddDocument(2, "funny pet with curly hair"sv, DocumentStatus::ACTUAL, { 1, 2 });
+        server.AddDocument(3, "funny pet with curly hair"sv, DocumentStatus::ACTUAL, { 1, 2 });        // same words
+        server.AddDocument(4, "funny pet and curly hair"sv, DocumentStatus::ACTUAL, { 1, 2 });         // differs in stop words only
+        server.AddDocument(5, "funny funny pet and nasty nasty rat"sv, DocumentStatus::ACTUAL, { 1, 2 });  // same set, other counts
+        server.AddDocument(6, "funny pet and not very nasty rat"sv, DocumentStatus::ACTUAL, { 1, 2 });
+        server.AddDocument(7, "very nasty rat and not very funny pet"sv, DocumentStatus::ACTUAL, { 1, 2 }); // same set, other order
+        server.AddDocument(8, "pet with rat and rat and rat"sv, DocumentStatus::ACTUAL, { 1, 2 });
+        server.AddDocument(9, "nasty rat with curly hair"sv, DocumentStatus::ACTUAL, { 1, 2 });
+
+        ASSERT(server.GetFingerprint(2) == server.GetFingerprint(4));
+        ASSERT(server.GetFingerprint(1) != server.GetFingerprint(2));
+        const std::vector<int> expected = { 3, 4, 5, 7 };
+        ASSERT(server.FindDuplicates(execution::seq) == expected);
+        ASSERT(server.FindDuplicates() == expected);
+
+        std::ostringstream output;
+        std::streambuf* const cout_buffer = std::cout.rdbuf(output.rdbuf());
+        RemoveDuplicates(server);
+        std::cout.rdbuf(cout_buffer);
+        ASSERT_EQUAL(output.str(), "Found duplicate document id 3\nFound duplicate document id 4\n"
+            "Found duplicate document id 5\nFound duplicate document id 7\n"s);
+        ASSERT_EQUAL(server.GetDocumentCount(), 5);
+        ASSERT_EQUAL(server.GetPendingRemovalCount(), 0);
+        ASSERT(server.FindDuplicates().empty());
+        ASSERT(std::vector<int>(server.begin(), server.end()) == std::vector<int>({ 1, 2, 6, 8, 9 }));
+    }
+
+    void TestRequestQueue() {
+        SearchServer server("and in at"s);
+        server.AddDocument(1, "curly cat curly tail"sv, DocumentStatus::ACTUAL, { 7, 2, 7 });
+        server.AddDocument(2, "curly dog and fancy collar"sv, DocumentStatus::ACTUAL, { 1, 2, 3 });
+        server.AddDocument(3, "big cat fancy collar "sv, DocumentStatus::BANNED, { 1, 2, 8 });
+
+        // only the last window_size requests count
+        RequestQueue request_queue(server, 4);
+        ASSERT_EQUAL(request_queue.AddFindRequest("empty request"sv).size(), 0u);
+        ASSERT_EQUAL(request_queue.AddFindRequest("curly dog"sv).size(), 2u);
+        ASSERT_EQUAL(request_queue.AddFindRequest("big collar"sv, DocumentStatus::BANNED).size(), 1u);
+        ASSERT_EQUAL(request_queue.GetNoResultRequests(), 1);
+        request_queue.AddFindRequest("sparrow"sv);
+        request_queue.AddFindRequest("big cat"sv, [](int, DocumentStatus, int rating) { return rating > 100; });
+        ASSERT_EQUAL(request_queue.GetNoResultRequests(), 2);
+        const RequestStats stats = request_queue.GetStats();
+        ASSERT_EQUAL(stats.requests, 4u);
+        ASSERT_EQUAL(stats.results, 3u);
+        ASSERT_EQUAL(stats.NoResultRate(), 0.5);
+        ASSERT(stats.max_latency >= stats.MeanLatency() && stats.MeanLatency().count() > 0);
+
+        // threads beyond shard count share shards, nothing is lost
+        RequestQueue shared_queue(server, 100000, 4);
+        std::vector<std::thread> threads;
+        for (int thread = 0; thread < 8; ++thread) {
+            threads.emplace_back([&shared_queue, thread]() {
+                for (int i = 0; i < 1000; ++i) {
+                    shared_queue.AddFindRequest(i % 4 == 0 ? "sparrow"sv : "curly"sv);
+                    if (thread == 0 && i % 100 == 0) {
+                        shared_queue.GetStats();
+                    }
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        const RequestStats shared_stats = shared_queue.GetStats();
+        ASSERT_EQUAL(shared_stats.requests, 8000u);
+        ASSERT_EQUAL(shared_stats.no_result_requests, 2000u);
+        ASSERT_EQUAL(shared_stats.results, 12000u);
+    }
+
+    void TestLatencyHistograms() {
+        using namespace std::chrono;
+        LatencyHistogram histogram(4);
+        ASSERT_EQUAL(histogram.GetPercentile(0.5).count(), 0);
+        for (int value = 1; value <= 1000; ++value) {
+            histogram.Record(nanoseconds(value));
+        }
+        // buckets are exact below 32 ns and within 1/32 above
+        const LatencySummary summary = histogram.GetSummary();
+        ASSERT_EQUAL(summary.count, 1000u);
+        ASSERT_EQUAL(histogram.GetPercentile(0.01).count(), 10);
+        ASSERT(summary.p50.count() >= 500 && summary.p50.count() <= 500 + 500 / 32);
+        ASSERT(summary.p90.count() >= 900 && summary.p90.count() <= 900 + 900 / 32);
+        ASSERT(summary.p99.count() >= 990 && summary.p99.count() <= 990 + 990 / 32);
+        ASSERT(summary.max.count() >= 1000 && summary.max.count() <= 1000 + 1000 / 32);
+        histogram.Record(hours(1));
+        ASSERT(histogram.GetPercentile(1.0) >= minutes(18));
+        histogram.Reset();
+        ASSERT_EQUAL(histogram.GetCount(), 0u);
+
+        // threads beyond shard count share shards, nothing is lost
+        std::vector<std::thread> threads;
+        for (int thread = 0; thread < 8; ++thread) {
+            threads.emplace_back([&histogram]() {
+                for (int i = 0; i < 1000; ++i) {
+                    histogram.Record(microseconds(i));
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        ASSERT_EQUAL(histogram.GetCount(), 8000u);
+
+        SearchServer server("and with"s);
+        server.AddDocument(1, "funny pet and nasty rat"sv, DocumentStatus::ACTUAL, { 7, 2, 7 });
+        server.AddDocument(2, "funny pet with curly hair"sv, DocumentStatus::ACTUAL, { 1, 2 });
+        server.AddTokenizedDocument(server.TokenizeDocument({ 3, "nasty rat"sv, DocumentStatus::ACTUAL, { 1 } }));
+        server.FindTopDocuments("curly rat"sv);
+        server.FindTopDocuments(execution::par, "curly rat"sv, DocumentStatus::BANNED);
+        server.FindTopDocuments(server.Prepare("nasty"sv));
+        server.MatchDocument(execution::par, "funny rat"sv, 1);
+        server.RemoveDocument(3);
+        // a batch is one sample
+        server.AddDocuments(execution::par, { { 4, "big dog"sv, DocumentStatus::ACTUAL, { 1 } },
+                                              { 5, "big cat"sv, DocumentStatus::ACTUAL, { 2 } } });
+        server.RemoveDocuments({ 4, 5 });
+        ProcessQueries(server, { "funny"s, "hair"s });
+        ASSERT_EQUAL(server.GetLatencySummary(ServerOperation::ADD_DOCUMENT).count, 4u);
+        ASSERT_EQUAL(server.GetLatencySummary(ServerOperation::REMOVE_DOCUMENT).count, 2u);
+        ASSERT_EQUAL(server.GetLatencySummary(ServerOperation::FIND_TOP_DOCUMENTS).count, 5u);     // queries of the batch too
+        ASSERT_EQUAL(server.GetLatencySummary(ServerOperation::MATCH_DOCUMENT).count, 1u);
+        ASSERT_EQUAL(server.GetLatencySummary(ServerOperation::PROCESS_QUERIES).count, 1u);
+
+        std::ostringstream dump;
+        server.DumpLatencies(dump);
+        const string text = dump.str();
+        ASSERT(text.find("AddDocument: count 4, p50 "s) == 0);
+        ASSERT(text.find("\nProcessQueries: count 1, "s) != string::npos);
+        ASSERT_EQUAL(std::count(text.begin(), text.end(), '\n'), 5);
+    }
+
+    void TestDuplicateDetection() {
+        SearchServer server("and with"s);
+        server.AddDocument(1, "funny pet and nasty rat"sv, DocumentStatus::ACTUAL, { 7, 2, 7 });
+        std::vector<std::pair<int, int>> reported;
+        server.EnableDuplicateDetection(SearchServer::DuplicateAction::REJECT,
+            [&reported](int document_id, int original_id) { reported.push_back({ document_id, original_id }); });
+
+        server.AddDocument(2, "nasty rat and funny funny pet"sv, DocumentStatus::ACTUAL, { 1 });      // same set
+        server.AddDocument(3, "funny pet with curly hair"sv, DocumentStatus::ACTUAL, { 1 });
+        server.AddDocument(4, "funny pet"sv, DocumentStatus::ACTUAL, { 1 });                          // subset is not a duplicate
+        server.AddDocuments(execution::par, { { 5, "curly hair and funny pet"sv, DocumentStatus::ACTUAL, { 1 } },
+                                              { 6, "big dog"sv, DocumentStatus::ACTUAL, { 1 } },
+                                              { 7, "dog big"sv, DocumentStatus::ACTUAL, { 1 } } });   // duplicate inside the batch
+        const std::vector<std::pair<int, int>> rejected = { { 2, 1 }, { 5, 3 }, { 7, 6 } };
+        ASSERT(reported == rejected);
+        ASSERT(std::vector<int>(server.begin(), server.end()) == std::vector<int>({ 1, 3, 4, 6 }));
+
+        // removed original frees its term set
+        server.RemoveDocument(1);
+        server.RemoveDocuments({ 3 });
+        server.AddDocument(2, "nasty rat and funny pet"sv, DocumentStatus::ACTUAL, { 1 });
+        server.AddTokenizedDocument(server.TokenizeDocument({ 5, "curly hair and funny pet"sv, DocumentStatus::ACTUAL, { 1 } }));
+        ASSERT_EQUAL(reported.size(), 3u);
+        ASSERT_EQUAL(server.GetDocumentCount(), 4);
+
+        // reported duplicates stay, next one is reported against the first live owner
+        server.EnableDuplicateDetection(SearchServer::DuplicateAction::REPORT,
+            [&reported](int document_id, int original_id) { reported.push_back({ document_id, original_id }); });
+        server.AddDocument(8, "big dog"sv, DocumentStatus::ACTUAL, { 1 });
+        server.RemoveDocument(6);
+        server.AddDocument(9, "big big dog"sv, DocumentStatus::ACTUAL, { 1 });
+        const std::vector<std::pair<int, int>> kept = { { 8, 6 }, { 9, 8 } };
+        ASSERT(std::equal(reported.begin() + 3, reported.end(), kept.begin(), kept.end()));
+        ASSERT_EQUAL(server.GetDocumentCount(), 5);
+
+        // table is rebuilt for renumbered terms of a snapshot
+        const string path = "test_duplicates_snapshot.bin";
+        server.SaveSnapshot(path);
+        SearchServer loaded("and with"s);
+        loaded.AddDocument(100, "big dog"sv, DocumentStatus::ACTUAL, { 1 });
+        loaded.EnableDuplicateDetection(SearchServer::DuplicateAction::REJECT);
+        loaded.LoadSnapshot(path);
+        loaded.AddDocument(10, "funny pet nasty rat"sv, DocumentStatus::ACTUAL, { 1 });
+        loaded.AddDocument(11, "funny pet nasty cat"sv, DocumentStatus::ACTUAL, { 1 });
+        ASSERT(std::vector<int>(loaded.begin(), loaded.end()) == std::vector<int>({ 2, 4, 5, 8, 9, 11 }));
+        std::remove(path.c_str());
+
+        server.DisableDuplicateDetection();
+        server.AddDocument(12, "big dog"sv, DocumentStatus::ACTUAL, { 1 });
+        ASSERT_EQUAL(reported.size(), 5u);
+        ASSERT_EQUAL(server.GetDocumentCount(), 6);
+    }
+
+    void TestFindNearDuplicates() {
+        // 20-word documents over a big vocabulary, every 4th one has a copy with one word replaced
+        SearchServer server("and with"s);
+        std::vector<std::set<std::string>> word_sets;
+        uint32_t seed = 12345;
+        const auto next_random = [&seed]() {
+            seed = seed * 1103515245u + 12345u;
+            return (seed >> 8) % 5000;
+        };
+        for (int id = 0; id < 200; ++id) {
+            std::set<std::string> words;
+            if (id % 4 == 1) {
+                words = word_sets.back();
+                words.erase(words.begin());
+                words.insert("replaced"s + std::to_string(id));
+            }
+            while (words.size() < 20) {
+                words.insert("w"s + std::to_string(next_random()));
+            }
+            std::string text;
+            for (const std::string& word : words) {
+                text += word + " and "s;
+            }
+            server.AddDocument(id, text, DocumentStatus::ACTUAL, { 1 });
+            word_sets.push_back(std::move(words));
+        }
+        server.AddDocument(200, "and with"sv, DocumentStatus::ACTUAL, { 1 });     // no terms
+
+        // brute force over every pair
+        std::vector<std::pair<int, int>> expected;
+        for (int lhs = 0; lhs < 200; ++lhs) {
+            for (int rhs = lhs + 1; rhs < 200; ++rhs) {
+                std::vector<std::string> common;
+                std::set_intersection(word_sets[lhs].begin(), word_sets[lhs].end(), word_sets[rhs].begin(), word_sets[rhs].end(), std::back_inserter(common));
+                if (common.size() * 10 >= (40 - common.size()) * 8) {
+                    expected.push_back({ lhs, rhs });
+                }
+            }
+        }
+        ASSERT_EQUAL(expected.size(), 50u);
+
+        for (const auto& near_duplicates : { server.FindNearDuplicates(0.8), server.FindNearDuplicates(execution::seq, 0.8) }) {
+            std::vector<std::pair<int, int>> found;
+            for (const SearchServer::NearDuplicate& pair : near_duplicates) {
+                ASSERT(std::abs(pair.similarity - 19.0 / 21.0) < 1e-9);
+                found.push_back({ pair.id, pair.similar_id });
+            }
+            ASSERT(found == expected);
+        }
+
+        // removed documents are not reported, exact duplicates have similarity 1
+        server.RemoveDocument(1);
+        server.AddDocument(300, "w1 w2 w3 w4"sv, DocumentStatus::ACTUAL, { 1 });
+        server.AddDocument(301, "w4 w3 w2 w1 and"sv, DocumentStatus::ACTUAL, { 1 });
+        const std::vector<SearchServer::NearDuplicate> near_duplicates = server.FindNearDuplicates(1.0);
+        ASSERT_EQUAL(near_duplicates.size(), 1u);
+        ASSERT_EQUAL(near_duplicates[0].id, 300);
+        ASSERT_EQUAL(near_duplicates[0].similar_id, 301);
+        ASSERT_EQUAL(near_duplicates[0].similarity, 1.0);
+        ASSERT_EQUAL(server.FindNearDuplicates(0.8).size(), 50u);
+
+        // cluster far over NEAR_DUPLICATE_BUCKET_LIMIT: 40 shared words and one own, every pair at 40/42
+        SearchServer cluster(""s);
+        std::string shared_words;
+        for (int word = 0; word < 40; ++word) {
+            shared_words += "s"s + std::to_string(word) + " "s;
+        }
+        const int cluster_size = 150;
+        for (int id = 0; id < cluster_size; ++id) {
+            cluster.AddDocument(id, shared_words + "own"s + std::to_string(id), DocumentStatus::ACTUAL, { 1 });
+        }
+        for (const auto& pairs : { cluster.FindNearDuplicates(0.9), cluster.FindNearDuplicates(execution::seq, 0.9) }) {
+            ASSERT_EQUAL(pairs.size(), static_cast<size_t>(cluster_size * (cluster_size - 1) / 2));
+            ASSERT(std::all_of(pairs.begin(), pairs.end(),
+                [](const SearchServer::NearDuplicate& pair) { return pair.id < pair.similar_id && std::abs(pair.similarity - 40.0 / 42.0) < 1e-9; }));
+        }
+
+        try {
+            server.FindNearDuplicates(0.0);
+            ASSERT_HINT(false, "Zero threshold must be rejected");
+        }
+        catch (const std::invalid_argument&) {
+        }
+    }
+
+#if 0   // method removed
+
+    void TestGetDocIDByNumber() {
+        const string content0 = "aaa";
+        const string content1 = "bbb";
+        const string content2 = "ccc";
+        const string content3 = "ddd";
+        const string content4 = "eee";
+        const std::vector<string> test_stop_words = { "in", "the" };
+
+        SearchServer server(test_stop_words);
+        server.AddDocument(12, content0, DocumentStatus::ACTUAL, { 1, 2, 3 });
+        server.AddDocument(13, content1, DocumentStatus::ACTUAL, { 1, 2, 3 });
+        server.AddDocument(14, content2, DocumentStatus::ACTUAL, { 1, 2, 3 });
+        server.AddDocument(15, content3, DocumentStatus::ACTUAL, { 1, 2, 3 });
+        server.AddDocument(16, content4, DocumentStatus::ACTUAL, { 1, 2, 3 });
+        {
+            int get_id = server.GetDocumentId(0);
+            ASSERT_EQUAL_HINT(get_id, 12, "Check GetDocumentId()! Number 0 getted wrong");
+        }
+        {
+            int get_id = server.GetDocumentId(1);
+            ASSERT_EQUAL_HINT(get_id, 13, "Check GetDocumentId()! Number 1 getted wrong");
+        }
+        {
+            int get_id = server.GetDocumentId(4);
+            ASSERT_EQUAL_HINT(get_id, 16, "Check GetDocumentId()! Number 4 (last) getted wrong");
+        }
+
+        try {
+            server.GetDocumentId(10);
+            ASSERT_HINT(false, "Check GetDocumentId()! Out of range check might be missed");
+        }
+        catch (const std::out_of_range& e) {
+            // Do nothing
+        }
+        catch (...) {
+            ASSERT_HINT(false, "Check GetDocumentId()! Out of range ID, wrong exception has been throwed");
+        }
+
+        try {
+            server.GetDocumentId(-6);
+            ASSERT_HINT(false, "Check GetDocumentId()! Negative doc number check might be missed");
+        }
+        catch (const std::out_of_range& e) {
+            // Do nothing
+        }
+        catch (...) {
+            ASSERT_HINT(false, "Check GetDocumentId()! Negative doc number, wrong exception has been throwed");
+        }
+    }
+
+#endif
+
+    template <typename QueriesProcessor>
+    void Test(string_view mark, QueriesProcessor processor, const SearchServer& search_server, const vector<string>& queries) {
+        LOG_DURATION(mark);
+        const auto documents_lists = processor(search_server, queries);
+    }
+
+#define TEST(processor) Test(#processor, processor, search_server, queries)
+
+
+#if 1
+
+    /*
+    Разместите код остальных тестов здесь
+    */
+
+    // Функция TestSearchServer является точкой входа для запуска тестов
+    void TestSearchServer() {
+        RUN_TEST(TestExcludeStopWordsFromAddedDocumentContent);
+        RUN_TEST(TestSplitIntoWords);
+        RUN_TEST(TestWordScanner);
+        RUN_TEST(TestSplitIntoWordsLazy);
+        RUN_TEST(TestCaseFoldingAndPunctuation);
+        RUN_TEST(TestPreparedQuery);
+        RUN_TEST(TestResultCache);
+        RUN_TEST(TestQueryArena);
+        RUN_TEST(TestIndexMemoryResource);
+        RUN_TEST(TestMatchDocuments);
+        RUN_TEST(TestTermIntersection);
+        RUN_TEST(TestMatchDocumentPositions);
+        RUN_TEST(TestProcessQueriesStreaming);
+        RUN_TEST(TestProcessQueriesFlat);
+        RUN_TEST(TestAsyncQueries);
+        RUN_TEST(TestExecutor);
+        RUN_TEST(TestProcessQueriesShared);
+        RUN_TEST(TestRemoveDuplicates);
+        RUN_TEST(TestRequestQueue);
+        RUN_TEST(TestLatencyHistograms);
+        RUN_TEST(TestDuplicateDetection);
+        RUN_TEST(TestFindNearDuplicates);
+        RUN_TEST(TestExcludeDocumentsByMinusWords);
+        RUN_TEST(TestMatchingDocumentsByQuerry);
+        RUN_TEST(TestSortResultsByRelevance);
+        RUN_TEST(TestAverageRatingCalculation);
+        RUN_TEST(TestFindingDocumentByPredicate);
+        RUN_TEST(TestFindingDocumentByStatus);
+        RUN_TEST(TestRelevanceCalculation);
+        RUN_TEST(TestServerConstructingByContainers);
+        RUN_TEST(TestAddDocuments);
+        RUN_TEST(TestRemoveDocumentsWithTombstones);
+        RUN_TEST(TestSnapshotSaveLoad);
+        RUN_TEST(TestMappedSearchServer);
+        RUN_TEST(TestWriteAheadLogRecovery);
+        RUN_TEST(TestIngestCorpus);
+        //RUN_TEST(TestGetDocIDByNumber);           // method removed
+        // Не забудьте вызывать остальные тесты здесь
+    }
+#endif
+    // --------- Окончание модульных тестов поисковой системы -----------
 }       // namespace MyUnitTests
\ No newline at end of file
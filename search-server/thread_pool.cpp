@@ -0,0 +1,78 @@
+#include "thread_pool.h"
+
+#include <stdexcept>
+#include <string>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+    void PinThread(std::thread& thread, int cpu) {
+#ifdef __linux__
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        if (cpu < 0 || cpu >= CPU_SETSIZE) {
+            throw std::runtime_error("Can't pin thread to CPU " + std::to_string(cpu));
+        }
+        CPU_SET(cpu, &cpus);
+        if (pthread_setaffinity_np(thread.native_handle(), sizeof(cpus), &cpus) != 0) {
+            throw std::runtime_error("Can't pin thread to CPU " + std::to_string(cpu));
+        }
+#else
+        throw std::runtime_error("Pinning threads to CPUs is supported on Linux only");
+#endif
+    }
+
+}
+
+ThreadPool::ThreadPool(size_t thread_count, size_t queue_capacity, const std::vector<int>& cpus)
+    : tasks_(queue_capacity) {
+    if (thread_count == 0 || queue_capacity == 0) {
+        throw std::invalid_argument("Thread pool needs threads and queue capacity");
+    }
+    workers_.reserve(thread_count);
+    try {
+        for (size_t i = 0; i < thread_count; ++i) {
+            workers_.emplace_back(&ThreadPool::WorkLoop, this);
+            if (!cpus.empty()) {
+                PinThread(workers_.back(), cpus[i % cpus.size()]);
+            }
+        }
+    }
+    catch (...) {
+        Shutdown();
+        throw;
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    Shutdown();
+}
+
+void ThreadPool::Shutdown() {
+    tasks_.Close();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+bool ThreadPool::Submit(Task task) {
+    return tasks_.Push(std::move(task));
+}
+
+bool ThreadPool::TrySubmit(Task& task) {
+    return tasks_.TryPush(task);
+}
+
+size_t ThreadPool::GetThreadCount() const {
+    return workers_.size();
+}
+
+void ThreadPool::WorkLoop() {
+    while (std::optional<Task> task = tasks_.Pop()) {
+        (*task)();
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "bounded_queue.h"
+
+// Fixed set of worker threads serving tasks from a bounded queue. Submit blocks while
+// the queue is full, so producers are slowed down instead of queueing without limit.
+// Tasks must not throw
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    // worker i is pinned to cpus[i % cpus.size()], empty cpus -> not pinned (Linux only).
+    // Throws std::invalid_argument on zero threads or zero capacity, std::runtime_error if pinning fails
+    ThreadPool(size_t thread_count, size_t queue_capacity, const std::vector<int>& cpus = {});
+    // queued tasks still run, then workers are joined
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // false if pool is shutting down
+    bool Submit(Task task);
+    // false if queue is full or pool is shutting down, task is left untouched then
+    bool TrySubmit(Task& task);
+
+    size_t GetThreadCount() const;
+
+private:
+    void WorkLoop();
+    void Shutdown();
+
+private:
+    BoundedQueue<Task> tasks_;
+    std::vector<std::thread> workers_;
+};
@@ -0,0 +1,297 @@
+#include "write_ahead_log.h"
+
+#include <cstdio>
+#include <cstring>
+#include <execution>
+#include <fstream>
+#include <set>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "index_snapshot.h"
+#include "search_server.h"
+
+namespace {
+
+    // HINT : record = < uint32 payload size, uint32 checksum, payload >
+    const size_t RECORD_HEADER_SIZE = 2 * sizeof(uint32_t);
+
+    template <typename T>
+    void Put(std::string& out, const T& value) {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    template <typename T>
+    T Get(const char*& pos) {
+        T value;
+        std::memcpy(&value, pos, sizeof(value));
+        pos += sizeof(value);
+        return value;
+    }
+
+    std::string MakeRecord(const std::string& payload) {
+        std::string record;
+        record.reserve(RECORD_HEADER_SIZE + payload.size());
+        Put(record, static_cast<uint32_t>(payload.size()));
+        Put(record, static_cast<uint32_t>(SnapshotChecksum(payload.data(), payload.size())));
+        record += payload;
+        return record;
+    }
+
+    // a rename is durable only once the directory holding the file is synced
+    bool SyncParentDirectory(const std::string& path) {
+        const size_t slash = path.rfind('/');
+        const std::string directory = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+        const int directory_fd = open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+        if (directory_fd < 0) {
+            return false;
+        }
+        const bool synced = fsync(directory_fd) == 0;
+        close(directory_fd);
+        return synced;
+    }
+
+}
+
+/************************************ CONSTRUCTORS ************************************/
+
+WriteAheadLog::WriteAheadLog(const std::string& log_path, const std::string& checkpoint_path, WalOptions options)
+    : log_path_(log_path)
+    , checkpoint_path_(checkpoint_path)
+    , options_(options) {
+    fd_ = open(log_path_.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd_ < 0) {
+        throw std::runtime_error("Can't open write-ahead log " + log_path_);
+    }
+    log_bytes_ = static_cast<uint64_t>(lseek(fd_, 0, SEEK_END));
+    flusher_ = std::thread(&WriteAheadLog::FlushLoop, this);
+}
+
+WriteAheadLog::~WriteAheadLog() {
+    {
+        std::lock_guard lock(mutex_);
+        stop_ = true;
+    }
+    has_work_.notify_one();
+    flusher_.join();
+    close(fd_);
+}
+
+/************************************ APPENDING ************************************/
+
+uint64_t WriteAheadLog::AppendAdd(int document_id, const std::string_view content, DocumentStatus status, const std::vector<int>& ratings) {
+    std::string payload;
+    payload.reserve(1 + 4 * sizeof(int32_t) + ratings.size() * sizeof(int32_t) + content.size());
+    Put(payload, RECORD_ADD);
+    Put(payload, static_cast<int32_t>(document_id));
+    Put(payload, static_cast<int32_t>(status));
+    Put(payload, static_cast<uint32_t>(ratings.size()));
+    for (const int rating : ratings) {
+        Put(payload, static_cast<int32_t>(rating));
+    }
+    Put(payload, static_cast<uint32_t>(content.size()));
+    payload.append(content);
+    return Append(MakeRecord(payload));
+}
+
+uint64_t WriteAheadLog::AppendRemove(int document_id) {
+    std::string payload;
+    Put(payload, RECORD_REMOVE);
+    Put(payload, static_cast<int32_t>(document_id));
+    return Append(MakeRecord(payload));
+}
+
+uint64_t WriteAheadLog::Append(const std::string& record) {
+    uint64_t lsn = 0;
+    {
+        std::lock_guard lock(mutex_);
+        if (failed_) {
+            throw std::runtime_error("Write-ahead log " + log_path_ + " is broken");
+        }
+        buffer_ += record;
+        lsn = ++appended_lsn_;
+    }
+    has_work_.notify_one();
+    if (options_.wait_durable) {
+        WaitDurable(lsn);
+    }
+    return lsn;
+}
+
+void WriteAheadLog::WaitDurable(uint64_t lsn) {
+    std::unique_lock lock(mutex_);
+    durable_.wait(lock, [&] { return durable_lsn_ >= lsn || failed_; });
+    if (durable_lsn_ < lsn) {
+        throw std::runtime_error("Write-ahead log " + log_path_ + " is broken");
+    }
+}
+
+void WriteAheadLog::Sync() {
+    uint64_t lsn = 0;
+    {
+        std::lock_guard lock(mutex_);
+        lsn = appended_lsn_;
+    }
+    WaitDurable(lsn);
+}
+
+/************************************ FLUSHER ************************************/
+
+void WriteAheadLog::FlushLoop() {
+    std::unique_lock lock(mutex_);
+    while (true) {
+        has_work_.wait(lock, [this] { return stop_ || !buffer_.empty(); });
+        if (buffer_.empty()) {
+            return;
+        }
+        if (options_.commit_delay.count() > 0 && !stop_) {
+            has_work_.wait_for(lock, options_.commit_delay, [this] { return stop_; });
+        }
+
+        // records appended during this fsync go to the next group
+        std::string group;
+        group.swap(buffer_);
+        const uint64_t group_lsn = appended_lsn_;
+        lock.unlock();
+
+        bool ok = true;
+        try {
+            WriteAll(group.data(), group.size());
+        }
+        catch (const std::runtime_error&) {
+            ok = false;
+        }
+
+        lock.lock();
+        if (ok) {
+            durable_lsn_ = group_lsn;
+            log_bytes_ += group.size();
+        }
+        else {
+            failed_ = true;
+        }
+        durable_.notify_all();
+    }
+}
+
+void WriteAheadLog::WriteAll(const char* data, size_t size) {
+    while (size > 0) {
+        const ssize_t written = write(fd_, data, size);
+        if (written < 0) {
+            throw std::runtime_error("Can't write write-ahead log " + log_path_);
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    if (fdatasync(fd_) != 0) {
+        throw std::runtime_error("Can't sync write-ahead log " + log_path_);
+    }
+}
+
+/************************************ RECOVERY ************************************/
+
+size_t WriteAheadLog::Recover(SearchServer& server) {
+    if (std::ifstream(checkpoint_path_).good()) {
+        server.LoadSnapshot(checkpoint_path_);
+    }
+
+    std::string image;
+    {
+        std::ifstream in(log_path_, std::ios::binary | std::ios::ate);
+        image.resize(static_cast<size_t>(in.tellg()));
+        in.seekg(0);
+        in.read(image.data(), static_cast<std::streamsize>(image.size()));
+    }
+
+    // crash between checkpoint and truncation replays records the checkpoint already has,
+    // skipping adds of present documents keeps replay idempotent
+    std::set<int> ids(server.begin(), server.end());
+    std::vector<SearchServer::NewDocument> batch;
+    auto apply_batch = [&] {
+        server.AddDocuments(std::execution::par, batch);
+        batch.clear();
+    };
+
+    size_t records = 0;
+    size_t valid_size = 0;
+    while (image.size() - valid_size >= RECORD_HEADER_SIZE) {
+        const char* pos = image.data() + valid_size;
+        const uint32_t size = Get<uint32_t>(pos);
+        const uint32_t checksum = Get<uint32_t>(pos);
+        if (image.size() - valid_size - RECORD_HEADER_SIZE < size
+            || static_cast<uint32_t>(SnapshotChecksum(pos, size)) != checksum) {
+            break;                                  // torn tail of the last group
+        }
+        const char* end = pos + size;
+
+        const uint8_t type = Get<uint8_t>(pos);
+        const int document_id = Get<int32_t>(pos);
+        if (type == RECORD_ADD) {
+            SearchServer::NewDocument document;
+            document.id = document_id;
+            document.status = static_cast<DocumentStatus>(Get<int32_t>(pos));
+            document.ratings.resize(Get<uint32_t>(pos));
+            for (int& rating : document.ratings) {
+                rating = Get<int32_t>(pos);
+            }
+            const uint32_t content_size = Get<uint32_t>(pos);
+            document.content = std::string_view(pos, content_size);
+            if (ids.insert(document_id).second) {
+                batch.push_back(std::move(document));
+            }
+            if (batch.size() >= options_.replay_batch) {
+                apply_batch();
+            }
+        }
+        else if (type == RECORD_REMOVE) {
+            apply_batch();
+            server.RemoveDocument(document_id);
+            ids.erase(document_id);
+        }
+        valid_size = end - image.data();
+        ++records;
+    }
+    apply_batch();
+
+    std::lock_guard lock(mutex_);
+    if (ftruncate(fd_, static_cast<off_t>(valid_size)) != 0) {
+        throw std::runtime_error("Can't truncate write-ahead log " + log_path_);
+    }
+    log_bytes_ = valid_size;
+    return records;
+}
+
+/************************************ CHECKPOINTS ************************************/
+
+bool WriteAheadLog::CheckpointDue() const {
+    std::lock_guard lock(mutex_);
+    return log_bytes_ + buffer_.size() >= options_.checkpoint_bytes;
+}
+
+void WriteAheadLog::Checkpoint(const SearchServer& server) {
+    Sync();
+
+    // rename is atomic, so a crash leaves either old or new checkpoint
+    const std::string tmp_path = checkpoint_path_ + ".tmp";
+    server.SaveSnapshot(tmp_path);
+    const int snapshot_fd = open(tmp_path.c_str(), O_RDONLY);
+    const bool synced = snapshot_fd >= 0 && fsync(snapshot_fd) == 0;
+    if (snapshot_fd >= 0) {
+        close(snapshot_fd);
+    }
+    if (!synced || std::rename(tmp_path.c_str(), checkpoint_path_.c_str()) != 0) {
+        throw std::runtime_error("Can't replace checkpoint " + checkpoint_path_);
+    }
+    // otherwise a crash could bring back the old checkpoint next to the emptied log
+    if (!SyncParentDirectory(checkpoint_path_)) {
+        throw std::runtime_error("Can't sync directory of checkpoint " + checkpoint_path_);
+    }
+
+    std::lock_guard lock(mutex_);
+    if (ftruncate(fd_, 0) != 0) {
+        throw std::runtime_error("Can't truncate write-ahead log " + log_path_);
+    }
+    log_bytes_ = 0;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "document.h"
+
+class SearchServer;
+
+struct WalOptions {
+    bool wait_durable = false;                          // mutation returns only after its fsync
+    std::chrono::microseconds commit_delay{ 0 };        // flusher waits to gather a bigger group
+    uint64_t checkpoint_bytes = 64ull << 20;            // log size that makes checkpoint due
+    size_t replay_batch = 4096;                         // documents tokenized together on replay
+};
+
+// Append-only log of SearchServer mutations with group commit.
+// Appends only copy a record into memory, a background flusher writes and fsyncs
+// everything gathered since its previous fsync in one go.
+// Checkpoint saves a snapshot of the server and truncates the log.
+class WriteAheadLog {
+public:
+    // throws std::runtime_error if log can't be opened
+    WriteAheadLog(const std::string& log_path, const std::string& checkpoint_path, WalOptions options = {});
+    ~WriteAheadLog();
+
+    WriteAheadLog(const WriteAheadLog&) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+    // return log sequence number of the record
+    uint64_t AppendAdd(int document_id, const std::string_view content, DocumentStatus status, const std::vector<int>& ratings);
+    uint64_t AppendRemove(int document_id);
+
+    // blocks until record lsn is on disk
+    void WaitDurable(uint64_t lsn);
+    void Sync();
+
+    // loads last checkpoint and replays the log into server, returns replayed records count.
+    // Call before attaching the log to the server
+    size_t Recover(SearchServer& server);
+
+    bool CheckpointDue() const;
+    void Checkpoint(const SearchServer& server);
+
+private:
+    enum RecordType : uint8_t {
+        RECORD_ADD = 1,
+        RECORD_REMOVE = 2,
+    };
+
+    uint64_t Append(const std::string& record);
+    void FlushLoop();
+    void WriteAll(const char* data, size_t size);
+
+private:
+    const std::string log_path_;
+    const std::string checkpoint_path_;
+    const WalOptions options_;
+    int fd_ = -1;
+
+    mutable std::mutex mutex_;
+    std::condition_variable has_work_;
+    std::condition_variable durable_;
+    std::string buffer_;                    // records not handed to flusher yet
+    uint64_t appended_lsn_ = 0;
+    uint64_t durable_lsn_ = 0;
+    uint64_t log_bytes_ = 0;                // appended since last checkpoint
+    bool failed_ = false;
+    bool stop_ = false;
+
+    std::thread flusher_;
+};